@@ -0,0 +1,52 @@
+#ifndef BALLISTICS_H
+#define BALLISTICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Shells fall under kGravity and are gone once they drop to kSeaLevel, the water plane
+// Graphics draws.
+constexpr float kGravity  = 9.81f;
+constexpr float kSeaLevel = -1.0f;
+
+// Where a shell launched from origin with velocity is t seconds later.
+inline glm::vec3 BallisticPosition(const glm::vec3& origin, const glm::vec3& velocity, float t) {
+    return glm::vec3(origin.x + velocity.x * t,
+                     origin.y + (velocity.y - 0.5f * kGravity * t) * t,
+                     origin.z + velocity.z * t);
+}
+
+// Seconds until a shell launched at height y0 with vertical speed vy comes down through
+// height y; 0 if it never gets that high.
+float TimeToFall(float y0, float vy, float y);
+
+// Per-call constants for SolveIntercepts: a target holding its height and XZ velocity.
+struct InterceptParams {
+    float targetX, targetY, targetZ;
+    float targetVelX, targetVelZ;
+    float muzzleSpeed; // the same for every shooter
+};
+
+// The shooters SolveIntercepts aims, all of length count.
+struct InterceptArrays {
+    const float* fromX;   // muzzle positions
+    const float* fromY;
+    const float* fromZ;
+    float*       velX;    // out: launch velocity, muzzleSpeed long
+    float*       velY;
+    float*       velZ;
+    float*       flightTime; // out: seconds until the shell reaches the aim point
+    uint8_t*     inRange;    // out: 0 if no arc reaches the target
+    size_t       count;
+};
+
+// Aims every shooter's shell at where the target will be when the shell gets there, on the
+// low (flatter, quicker) arc. Starts from the lead for a flat shot at muzzleSpeed, then
+// alternates the closed-form low-arc elevation for the aim point with moving the aim point
+// to the new flight time, a fixed number of rounds. A target out of reach is shot at 45
+// degrees toward its predicted position, the longest shot there is, with inRange = 0.
+// Returns how many shooters have the target in range.
+size_t SolveIntercepts(const InterceptArrays& a, const InterceptParams& p);
+
+#endif // BALLISTICS_H
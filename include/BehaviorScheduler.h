@@ -0,0 +1,132 @@
+#ifndef BEHAVIOR_SCHEDULER_H
+#define BEHAVIOR_SCHEDULER_H
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+#include "TimerWheel.h"
+
+// A behavior written as a C++20 coroutine: it runs until it awaits one of
+// BehaviorScheduler's Sleep / WaitSignal, and carries on from there when the scheduler
+// resumes it. Created suspended; hand it to BehaviorScheduler::Start.
+class BehaviorTask {
+public:
+    struct promise_type {
+        BehaviorTask get_return_object() {
+            return BehaviorTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    BehaviorTask() = default;
+    BehaviorTask(BehaviorTask&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    BehaviorTask& operator=(BehaviorTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    BehaviorTask(const BehaviorTask&) = delete;
+    BehaviorTask& operator=(const BehaviorTask&) = delete;
+    ~BehaviorTask() { reset(); }
+
+    // Gives up ownership of the coroutine.
+    std::coroutine_handle<> Release() { return std::exchange(handle, {}); }
+
+private:
+    explicit BehaviorTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    void reset() {
+        if (handle) handle.destroy();
+        handle = {};
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Runs BehaviorTasks on simulation ticks. A waiting task costs nothing per tick: sleepers
+// sit in a TimerWheel keyed by wake tick, and a task waiting for a signal is only touched
+// when Signal names it. Everything runs on the calling thread, and tasks due on the same
+// tick resume in the order their waits began, so the same calls always give the same run.
+class BehaviorScheduler {
+public:
+    static constexpr uint32_t kNone = ~0u;
+
+    BehaviorScheduler() = default;
+    ~BehaviorScheduler() { StopAll(); }
+
+    BehaviorScheduler(const BehaviorScheduler&) = delete;
+    BehaviorScheduler& operator=(const BehaviorScheduler&) = delete;
+
+    // Takes the task over; it first runs at the next RunUntil. Returns its id, valid until
+    // the task finishes or is stopped (ids are reused after that).
+    uint32_t Start(BehaviorTask task);
+    // Destroys a task wherever it is waiting. Ignores ids that aren't running.
+    void Stop(uint32_t id);
+    void StopAll();
+    // Stops every task and restarts the clock at tick, e.g. for a new match.
+    void Reset(uint32_t tick = 0);
+
+    // Sets the current tick and resumes every task due by then.
+    void RunUntil(uint32_t tick);
+    // Resumes a task right away if it is waiting for a signal; otherwise does nothing.
+    void Signal(uint32_t id);
+
+    uint32_t Now() const { return now; }
+    // Id of the task being resumed, for use inside a task; kNone outside one.
+    uint32_t Current() const { return current; }
+
+    size_t   Live() const { return live; }
+    size_t   WaitingForSignal() const { return waitingSignal; }
+    uint64_t Resumes() const { return resumes; }
+    const TimerWheel& GetTimers() const { return timers; }
+
+    // co_await Sleep(n): resume n ticks from now (at least one).
+    struct SleepAwaiter {
+        BehaviorScheduler* scheduler;
+        uint32_t           ticks;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<>) { scheduler->sleepCurrent(ticks); }
+        void await_resume() const noexcept {}
+    };
+    SleepAwaiter Sleep(uint32_t ticks) { return SleepAwaiter{ this, ticks }; }
+
+    // co_await WaitSignal(): resume when someone calls Signal with this task's id.
+    struct SignalAwaiter {
+        BehaviorScheduler* scheduler;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<>) { scheduler->waitCurrent(); }
+        void await_resume() const noexcept {}
+    };
+    SignalAwaiter WaitSignal() { return SignalAwaiter{ this }; }
+
+private:
+    struct Slot {
+        std::coroutine_handle<> handle;
+        TimerHandle             sleep;  // pending while the task sleeps
+        bool                    waitingSignal = false;
+    };
+
+    void schedule(uint32_t id, uint32_t due);
+    void sleepCurrent(uint32_t ticks);
+    void waitCurrent();
+    void resume(uint32_t id);
+    void release(uint32_t id);
+
+    std::vector<Slot>     slots;
+    std::vector<uint32_t> freeSlots;
+    TimerWheel            timers;     // tagged with task ids
+    uint32_t now     = 0;
+    uint32_t current = kNone;
+    uint64_t resumes = 0;
+    size_t   live          = 0;
+    size_t   waitingSignal = 0;
+};
+
+#endif // BEHAVIOR_SCHEDULER_H
@@ -0,0 +1,11 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <string>
+
+// Self-checks and micro-benchmarks for the simulation's data structures, run with
+// `BoatEscape --bench NAME`. Each checks its results against a brute-force oracle
+// before timing anything, and returns non-zero if they disagree.
+int RunBenchmark(const std::string& name);
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,49 @@
+#ifndef BUOYANCY_H
+#define BUOYANCY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hull size and how stiffly a boat follows the water. Heave, pitch and roll each act as a
+// damped spring pulled toward what the sea under the hull asks for.
+struct BuoyancyParams {
+    float length;    // between the bow and stern sample points
+    float beam;      // between the two side sample points
+    float stiffness; // spring rate, 1/s^2
+    float damping;   // 1/s
+};
+
+// The boats to float, all of length count. Pose is relative to the still water: heave is
+// how far above kSeaLevel the hull rides, pitch (bow up) and roll (the side at
+// (bowZ, -bowX) up) are in radians.
+struct BuoyancyArrays {
+    const float* posX;
+    const float* posZ;
+    const float* bowX;  // unit heading in XZ
+    const float* bowZ;
+    float*       heave;
+    float*       pitch;
+    float*       roll;
+    float*       heaveRate;
+    float*       pitchRate;
+    float*       rollRate;
+    size_t       count;
+};
+
+// Floats boats on the sea Waves.h describes. Each call samples the surface under four points
+// of every hull (bow, stern and both sides) in one SampleWaveHeights batch, then steps every
+// pose toward the heave, pitch and roll those heights give. Keeps its sample buffers between
+// calls, so a steady fleet allocates nothing.
+class Buoyancy {
+public:
+    void Float(const BuoyancyArrays& boats, const BuoyancyParams& p, float time, float dt);
+
+    uint64_t Samples() const { return samples; } // wave heights taken, since construction
+
+private:
+    std::vector<float> sampleX, sampleZ, sampleHeight;
+    uint64_t samples = 0;
+};
+
+#endif // BUOYANCY_H
@@ -0,0 +1,46 @@
+#ifndef ENEMY_KERNEL_H
+#define ENEMY_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Per-tick constants for SteerEnemies.
+struct EnemySteerParams {
+    float playerX, playerY, playerZ;
+    float speed;         // the same for every enemy boat
+    float keepAway;      // back off inside this distance
+    float approachSlack; // close in beyond keepAway + approachSlack
+    float fireRange;
+};
+
+// The enemy arrays the kernel reads and writes, all of length count.
+struct EnemySteerArrays {
+    float*         posX;
+    float*         posY;
+    float*         posZ;
+    const uint8_t* armed;  // 1 while the boat's gun is loaded
+    float*         faceX;  // unit heading in XZ
+    float*         faceZ;
+    const float*   dt;     // seconds to advance each boat by
+    const uint8_t* active;
+    uint8_t*       fire;   // out: 1 if the boat should shoot this tick
+    size_t         count;
+};
+
+// One step of seek / flee / face / fire-eligibility for every active enemy, all decided
+// from its position at the start of the step. Each boat advances by its own dt, so boats
+// that have not been stepped for a while can catch up in one go:
+// - beyond keepAway + approachSlack the boat moves toward the player at speed, inside
+//   keepAway it backs off at half speed;
+// - the heading turns to the XZ direction of the player (unless it is nearly on top of them);
+// - fire is set within (keepAway, fireRange] if the boat is armed.
+// Inactive boats are left untouched with fire = 0.
+void SteerEnemies(const EnemySteerArrays& a, const EnemySteerParams& p);
+
+// Plain C++ version used without SSE. Produces bit-identical results to the SIMD paths.
+void SteerEnemiesScalar(const EnemySteerArrays& a, const EnemySteerParams& p);
+
+// Which path SteerEnemies takes in this build: "avx", "sse2" or "scalar".
+const char* EnemySteerPath();
+
+#endif // ENEMY_KERNEL_H
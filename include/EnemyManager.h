@@ -1,41 +1,206 @@
 #ifndef ENEMY_MANAGER_H
 #define ENEMY_MANAGER_H
 
+#include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
-#include "Game.h" 
+#include "Game.h"
+#include "SpatialHash.h"
+#include "NavField.h"
+#include "BehaviorScheduler.h"
+#include "Buoyancy.h"
 
+class JobSystem;
 class MountainManager;
 class ProjectileManager;
+class Rng;
 
-struct EnemyBoat {
-    glm::vec3 position;
-    float rotation;
-    float speed;
-    bool active;
-    float shootCooldown;
-    float maxShootCooldown;
-    
-    EnemyBoat(glm::vec3 pos) : position(pos), rotation(0.0f), speed(2.0f), active(true), 
-                               shootCooldown(0.0f), maxShootCooldown(2.0f) {}
+// Enemy boats as parallel arrays; index i in every array is one boat. Hot arrays are
+// read and written by the steering kernel every tick, cold ones only on spawn, firing
+// and rendering.
+struct EnemyStore {
+    // Hot
+    std::vector<float>   posX, posY, posZ;
+    std::vector<uint8_t> armed;          // 1 while the gun is loaded; set and cleared by the boat's behavior
+    std::vector<int8_t>  strafe;         // -1 / +1 while swinging out to that side after a shot, else 0
+    std::vector<float>   faceX, faceZ;   // unit heading in XZ
+    std::vector<uint8_t> active;         // 0 once sunk, until EnemyManager::RetireDestroyed
+
+    // Cold
+    std::vector<float>     maxCooldown;
+    std::vector<glm::vec3> prevPosition; // start of the current tick, for interpolated rendering
+    std::vector<float>     prevFaceX, prevFaceZ;
+    std::vector<uint32_t>  lastThink;    // tick of the boat's last AI step
+    std::vector<uint32_t>  behavior;     // id of the boat's task in EnemyManager's scheduler
+    std::vector<float>     heave, pitch, roll;             // pose on the waves, see Buoyancy.h
+    std::vector<float>     heaveRate, pitchRate, rollRate;
+
+    size_t    Size() const { return posX.size(); }
+    glm::vec3 Position(size_t i) const { return glm::vec3(posX[i], posY[i], posZ[i]); }
+    void      SetPosition(size_t i, const glm::vec3& p) { posX[i] = p.x; posY[i] = p.y; posZ[i] = p.z; }
+    // Heading as a yaw in degrees (0 faces +Z), for rendering.
+    float     RotationDeg(size_t i) const;
+    float     PrevRotationDeg(size_t i) const;
+
+    void Push(const glm::vec3& pos);
+    void Clear();
+    // Removes every boat for which remove(i) is true, keeping the others in order.
+    template <typename Pred>
+    void RemoveIf(Pred remove) {
+        size_t out = 0;
+        for (size_t i = 0; i < Size(); ++i) {
+            if (remove(i)) continue;
+            if (out != i) move(i, out);
+            ++out;
+        }
+        resize(out);
+    }
+
+private:
+    void move(size_t from, size_t to);
+    void resize(size_t n);
+};
+
+// A boat parked outside the active radius, with no behavior task and no per-tick AI: just
+// enough to put it back where it was. The pool is advanced a slice per tick, so each boat
+// moves a few times a second.
+struct DormantBoat {
+    int32_t  x, z;     // position in 1/16 units
+    uint32_t lastStep; // think tick it was last advanced
+    int16_t  y;        // in 1/256 units
+    uint8_t  heading;  // yaw in 256ths of a turn
+    uint8_t  reload;   // ticks of reload left, 0 once the gun is loaded
+};
+
+// AI level of detail after the last Think: boats per distance tier, and how many it stepped.
+struct EnemyAiStats {
+    size_t   nearCount = 0; // stepped every tick
+    size_t   midCount  = 0; // stepped every few ticks
+    size_t   farCount  = 0; // stepped round robin under a fixed per-tick budget
+    size_t   stepped   = 0;
+    uint64_t steppedTotal = 0; // summed over every Think since Init
+    uint64_t thinks       = 0;
+
+    // Interest management, since Init.
+    size_t   dormantCount = 0;   // parked after the last Think
+    uint64_t spawned      = 0;   // fresh boats
+    uint64_t slept        = 0;   // live boats parked
+    uint64_t woken        = 0;   // parked boats brought back
+    uint64_t forgotten    = 0;   // parked boats dropped for being far away or the pool being full
+
+    // Gunnery, since Init.
+    uint64_t shellsFired      = 0;
+    uint64_t shellsOutOfRange = 0; // fired at 45 degrees because no arc reached the player
+    uint64_t sightLines       = 0; // boats ready to fire whose line to the player was tested
+    uint64_t sightBlocked     = 0; // of those, held back by a mountain in the way
+    double   sightSeconds     = 0.0; // wall time spent in the line-of-sight queries
 };
 
 class EnemyManager {
 public:
     EnemyManager();
 
-    void Init(Difficulty difficulty);
-    void Update(float dt, const glm::vec3& playerPosition, ProjectileManager& projectileManager, MountainManager& mountainManager);
-    void SpawnEnemy(const glm::vec3& playerPosition, MountainManager& mountainManager);
-    
-    const std::vector<EnemyBoat>& GetEnemies() const { return enemies; }
-    std::vector<EnemyBoat>& GetEnemies() { return enemies; }
+    void Init(Difficulty difficulty, Rng& rng);
+    // Spreads Think's per-boat work over the pool's threads; null runs it on the caller.
+    void SetJobSystem(JobSystem* jobSystem) { jobs = jobSystem; }
+    // One tick is Think then FlushShots. Think parks boats that left the active radius,
+    // wakes and spawns boats, steers them, picks who fires (only boats with a clear line
+    // to the player), aims the shots and resumes the shooters' behaviors;
+    // FlushShots hands the shots to the projectile pool in boat order.
+    void Think(float dt, const glm::vec3& playerPosition, const MountainManager& mountainManager);
+    void FlushShots(ProjectileManager& projectileManager);
+
+    // Moves every boat's heave, pitch and roll one step toward the sea under it.
+    // time is the wave clock in seconds.
+    void FloatBoats(float time, float dt);
+    uint64_t WaveSampleCount() const { return buoyancy.Samples(); }
+
+    const EnemyStore& GetEnemies() const { return enemies; }
+    EnemyStore& GetEnemies() { return enemies; }
+    const EnemyAiStats& GetAiStats() const { return aiStats; }
+    const NavField& GetNavField() const { return navField; }
+    const BehaviorScheduler& GetBehaviors() const { return behaviors; }
+
+    // Marks a boat as sunk. It stays in place (indices stay valid) until RetireDestroyed.
+    void Destroy(size_t i);
+    // Drops every sunk boat, keeping the rest in order. Called once at the end of a tick,
+    // so outside that window the store holds live boats only.
+    void RetireDestroyed();
+    uint64_t RetiredCount() const { return retired; }
 
 private:
-    std::vector<EnemyBoat> enemies;
-    float spawnTimer;
+    // A shot picked by Think, applied by FlushShots in enemy order. stepRange fills in the
+    // muzzle; the velocity comes from aiming the whole tick's shots together.
+    struct FireRequest {
+        uint32_t  enemy;
+        glm::vec3 muzzle;
+        glm::vec3 velocity;
+    };
+
+    BehaviorTask gunnerBehavior(uint32_t reloadTicks);
+    BehaviorTask waveBehavior();
+    uint32_t ticksFor(float seconds) const;
+    // reloadTicks: how long the gun stays unloaded, for boats coming out of the dormant pool.
+    void spawn(const glm::vec3& position, uint32_t reloadTicks = 0);
+    void putToSleep(size_t i);
+    void stepDormant(const glm::vec3& playerPosition, const MountainManager& mountainManager);
+    // Stops the behaviors of the boats remove(i) picks, drops those boats and re-points
+    // the remaining behaviors at their new indices.
+    template <typename Pred>
+    void removeBoats(Pred remove);
+    void sampleSpawnBatch(const glm::vec3& playerPosition, const MountainManager& mountainManager, size_t count);
+    void pickBoatsToStep(const glm::vec3& playerPosition);
+    void stepRange(size_t begin, size_t end, const glm::vec3& playerPosition, float dt,
+                   const MountainManager& mountainManager, std::vector<FireRequest>& fired);
+    void dropBlockedShots(const glm::vec3& playerPosition, const MountainManager& mountainManager);
+    void aimShots(const glm::vec3& playerPosition);
+
+    EnemyStore enemies;
     Difficulty currentDifficulty;
     int maxEnemies;
+    Rng* rng = nullptr; // enemy stream of Game's RandomService
+    JobSystem* jobs = nullptr;
+    uint32_t thinkTick = 0;
+    float    tickSeconds = 1.0f / 60.0f; // dt of the last Think, for turning behavior delays into ticks
+    size_t   farCursor = 0; // where the next round-robin slice of far boats starts
+    // The player's position at the last Think and its velocity since the one before, for leading shots.
+    glm::vec3 lastPlayerPosition = glm::vec3(0.0f);
+    glm::vec3 playerVelocity     = glm::vec3(0.0f);
+    EnemyAiStats aiStats;
+    Buoyancy     buoyancy;
+
+    // Spawn positions drawn by the last batch, released a few per tick. waveDue is raised by
+    // the wave behavior when the next batch may be drawn.
+    std::vector<glm::vec3> pendingSpawns;
+    size_t      nextSpawn = 0;
+    bool        waveDue   = false;
+    uint32_t    waveTask  = BehaviorScheduler::kNone;
+    SpatialHash spawnGrid;  // boats near the spawn annulus, while a batch is drawn
+    SpatialHash flockGrid;  // every live boat at the start of the tick, for flocking
+    NavField    navField;   // routes around the mountains to the player, shared by every boat
+    BehaviorScheduler     behaviors;
+    std::vector<uint32_t> behaviorBoat; // boat index of each behavior id
+    std::vector<DormantBoat> dormant;
+    size_t   dormantCursor = 0; // where the next slice of the dormant pool starts
+    size_t   destroyedPending = 0;
+    uint64_t retired = 0; // boats retired since Init
+
+    // Per-tick scratch, kept so Think doesn't reallocate. The boats picked for this tick
+    // are gathered into the step* arrays, run through the kernel and scattered back.
+    std::vector<uint32_t>  toStep;
+    std::vector<uint32_t>  farBoats;
+    std::vector<float>     stepX, stepY, stepZ, stepFaceX, stepFaceZ, stepDt;
+    std::vector<uint8_t>   stepArmed;
+    std::vector<uint8_t>   stepActive;
+    std::vector<glm::vec3> moveTo;
+    std::vector<uint8_t>   moveBlocked;
+    std::vector<uint8_t>   fireNow;
+    std::vector<std::vector<FireRequest>> fireBuffers; // one per job system thread
+    std::vector<FireRequest>              fireMerged;
+    std::vector<float>   aimX, aimY, aimZ, aimVelX, aimVelY, aimVelZ, aimTime; // fireMerged's muzzles and solutions
+    std::vector<uint8_t> aimInRange;
+    std::vector<float>   sightX, sightZ, sightToX, sightToZ; // fireMerged's sight lines to the player
+    std::vector<uint8_t> sightBlocked;
 };
 
-#endif 
+#endif
@@ -0,0 +1,35 @@
+#ifndef FLOCKING_H
+#define FLOCKING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class SpatialHash;
+
+struct FlockParams {
+    float  radius;            // neighbors are boats within this XZ distance
+    float  separationRadius;  // push away from neighbors closer than this
+    size_t maxNeighbors;      // at most this many neighbors are considered per boat
+    float  separationWeight;
+    float  alignmentWeight;
+    float  cohesionWeight;
+    float  maxSpeed;          // the result is clamped to this length
+};
+
+// Start-of-tick boat state the steering reads; index = id in the grid.
+struct FlockView {
+    const glm::vec3* position;
+    const float*     headingX; // unit heading in XZ
+    const float*     headingZ;
+};
+
+// Separation / alignment / cohesion for boat self as an XZ velocity, from at most
+// maxNeighbors boats found through grid (built over boats.position). Boats with no
+// neighbors get zero.
+glm::vec2 FlockSteer(const SpatialHash& grid, const FlockView& boats, uint32_t self, const FlockParams& p);
+
+// Same rule over every boat in [0, count), for checking FlockSteer.
+glm::vec2 FlockSteerBruteForce(const FlockView& boats, size_t count, uint32_t self, const FlockParams& p);
+
+#endif // FLOCKING_H
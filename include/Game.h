@@ -3,30 +3,89 @@
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 #include "Camera.h"
 #include "BoatSkinIds.h"
+#include "InputState.h"
+#include "Replay.h"
+#include "Random.h"
+#include "SpatialHash.h"
 
 class Graphics;
 class Player;
 class EnemyManager;
+class JobSystem;
+class TaskGraph;
 class ProjectileManager;
 class MountainManager;
+class ModelManager;
 class UserInterface;
 
 enum GameState { MAIN_MENU, DIFFICULTY_MENU, SETTINGS_MENU, PLAYING, PAUSED, GAME_OVER };
 enum Difficulty { EASY, HARD };
 
+// Command-line options. ticks/seed/difficulty only apply to headless runs; a replay
+// brings its own seed, difficulty, skin and tick rate.
+struct LaunchOptions {
+    bool         headless   = false;
+    long long    ticks      = 10000;
+    unsigned int seed       = 0;
+    Difficulty   difficulty = HARD;
+    int          tickRate   = 60;
+    std::string  recordPath;        // save each finished match here
+    std::string  replayPath;        // play this recording back instead of live input
+    bool         maxSpeed   = false; // windowed replay: one tick per rendered frame
+    std::string  benchmark;         // run this self-check/benchmark and exit
+    unsigned     threads    = 0;    // simulation threads including the main one; 0 = all cores
+    bool         dumpTaskGraph = false; // print each tick's critical path
+};
+
+// Accumulated wall-clock seconds spent in each Update phase.
+struct PhaseTimings {
+    double player      = 0.0;
+    double projectiles = 0.0;
+    double enemies     = 0.0;
+    double mountains   = 0.0;
+    double buoyancy    = 0.0;
+    double collisions  = 0.0;
+    double frame        = 0.0; // whole task graph, start to finish
+    double criticalPath = 0.0; // longest chain of dependent phases
+};
+
 class Game {
 public:
     Game(unsigned int width, unsigned int height);
     ~Game();
 
     void Init();
-    void ProcessInput(float dt);
+    int  RunHeadless(const LaunchOptions& options);
+    InputState PollInput();
+    void ProcessInput(const InputState& input);
+    int  Advance(double frameSeconds);
     void Update(float dt);
     void Render();
 
+    // Simulation tick rate in Hz (30, 60 or 120 are the supported settings).
+    void SetTickRate(int hz);
+    inline int GetTickRate() const { return tickRate; }
+    inline int64_t GetTick() const { return simTick; }
+
+    // Threads the simulation may use, the main one included (0 = one per hardware thread).
+    // Takes effect when the simulation is created, so call it before Init / RunHeadless.
+    void SetThreadCount(unsigned threads) { threadCount = threads; }
+    // Print every tick's critical path through the update task graph.
+    void SetDumpTaskGraph(bool enabled) { dumpTaskGraph = enabled; }
+
+    // Record every match to path (overwritten on each game over).
+    void SetRecordPath(const std::string& path) { recordPath = path; }
+    // Loads a recording and starts its match; live input no longer drives the player.
+    bool StartReplay(const std::string& path);
+    inline bool IsReplaying() const { return replay.IsLoaded(); }
+
     inline bool IsRunning() const { return window && !glfwWindowShouldClose(window); }
     inline GLFWwindow* GetWindow() const { return window; }
 
@@ -36,6 +95,9 @@ public:
 public:
     bool  firstMouse;
     double lastX, lastY;
+    // Cursor movement accumulated by the GLFW callback until the next PollInput.
+    float pendingMouseX = 0.0f;
+    float pendingMouseY = 0.0f;
     bool  isFirstPerson;
     Camera shipCamera;
 
@@ -52,12 +114,21 @@ public:
     int boatSkinIndex;
 
     Player* GetPlayer() { return player.get(); }
+    const PhaseTimings& GetPhaseTimings() const { return phaseTimings; }
 
 private:
-    void startNewGame();
+    void startNewGame(uint32_t seed);
     void triggerGameOver();
+    void finishRecording();
+    void finishReplay();
+    TickCommand nextTickCommand();
+    void buildUpdateGraph();
+    void buildShotGrid();
     void checkCollisions();
-    void ProcessMenuInput(float dt);
+    void ProcessMenuInput(const InputState& input);
+    void applyMouseLook(const InputState& input);
+    void initSimulation();
+    void printHeadlessReport(long long ticks, double wallSeconds, int matches) const;
 
 private:
     GLFWwindow* window;
@@ -68,12 +139,16 @@ private:
     std::unique_ptr<EnemyManager>      enemyManager;
     std::unique_ptr<ProjectileManager> projectileManager;
     std::unique_ptr<MountainManager>   mountainManager;
+    std::unique_ptr<ModelManager>      boatHulls; // collision hulls only; Graphics has its own for drawing
     std::unique_ptr<UserInterface>     ui;
+    std::unique_ptr<JobSystem>         jobs;
+    std::unique_ptr<TaskGraph>         updateGraph;
+    std::vector<double PhaseTimings::*> taskPhase; // which timing each graph task adds to
 
     GameState  state;
     Difficulty difficulty;
 
-    float gameTime;
+    double gameTime;
     int   score;
     int   enemiesDestroyed;
     int   finalScore;
@@ -83,7 +158,40 @@ private:
     int selectedSettingsItem;
     int selectedPauseItem;
 
-    float waveTime;
+    double waveTime;
+
+    // Fixed-timestep state. Advance() runs whole ticks of tickDt out of the accumulator
+    // and leaves renderAlpha as the fraction of a tick to interpolate rendering by.
+    unsigned threadCount = 0;
+    bool     dumpTaskGraph = false;
+    int     tickRate = 60;
+    double  tickDt   = 1.0 / 60.0;
+    double  tickAccumulator = 0.0;
+    int64_t simTick  = 0;
+    float   renderAlpha = 1.0f;
+
+    PhaseTimings phaseTimings;
+    InputState   lastInput;
+    TickCommand  tickCommand;      // the command Update's player task applies
+    float        tickSeconds = 0.0f;
+
+    // Mouse-look yaw waiting for the next tick, in degrees.
+    float        pendingYaw = 0.0f;
+    uint32_t     matchSeed  = 0;
+    RandomService rngService;
+    SpatialHash   shotGrid;   // broadphase over player shots, rebuilt each tick
+    std::vector<std::pair<uint32_t, uint32_t>> shotHits; // (projectile, enemy) candidates, reused every tick
+    std::vector<glm::vec3> shotPositions;   // player shots' positions this tick, by projectile index
+    std::vector<glm::vec3> shotPrevPositions; // and a tick ago, for the swept hit tests
+    float                  shotStep = 0.0f;   // farthest any player shot moved over the last tick
+    std::vector<uint32_t>  shotCandidates;    // shots in one enemy's bounding sphere, before the hull test
+    uint64_t hullTests  = 0; // segment-vs-hull tests run, over the whole session
+    uint64_t hullMisses = 0; // of those, shots that were inside a boat's bounds but missed its hull
+    std::vector<uint32_t> playerHits;       // enemy shots that hit the player this tick
+    std::vector<uint32_t> spentProjectiles; // checkCollisions scratch, reused every tick
+    std::string  recordPath;
+    ReplayRecorder recorder;
+    ReplayPlayer   replay;
 
     float musicVolume = 0.7f;
     bool  enableScreenShake = true;
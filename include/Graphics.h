@@ -23,6 +23,7 @@ public:
                 const ProjectileManager& projectileManager,
                 const MountainManager& mountainManager,
                 float waveTime,
+                float interpolationAlpha,
                 float cameraYaw,
                 float cameraPitch,
                 float cameraDistance,
@@ -0,0 +1,51 @@
+#ifndef INPUT_STATE_H
+#define INPUT_STATE_H
+
+#include <cstdint>
+
+// Logical buttons. Game::PollInput maps GLFW keys onto these; bots, replays and
+// headless runs can fill an InputState directly without a window.
+enum InputButton : uint32_t {
+    BTN_FORWARD         = 1u << 0,  // W
+    BTN_BACK            = 1u << 1,  // S
+    BTN_TURN_LEFT       = 1u << 2,  // A
+    BTN_TURN_RIGHT      = 1u << 3,  // D
+    BTN_BOOST           = 1u << 4,  // Shift
+    BTN_FIRE            = 1u << 5,  // Space
+    BTN_ARROW_UP        = 1u << 6,
+    BTN_ARROW_DOWN      = 1u << 7,
+    BTN_ARROW_LEFT      = 1u << 8,
+    BTN_ARROW_RIGHT     = 1u << 9,
+    BTN_CONFIRM         = 1u << 10, // Enter
+    BTN_CANCEL          = 1u << 11, // Esc
+    BTN_VIEW_FIRST      = 1u << 12, // 1
+    BTN_VIEW_THIRD      = 1u << 13, // 2
+    BTN_DEBUG_MOUNTAINS = 1u << 14, // C
+    BTN_PAUSE           = 1u << 15  // P
+};
+
+// One input sample: buttons held now, buttons held in the previous sample
+// (for edge detection) and the raw cursor movement since the previous sample.
+struct InputState {
+    uint32_t down     = 0;
+    uint32_t previous = 0;
+    float    mouseDeltaX = 0.0f; // pixels, +x right
+    float    mouseDeltaY = 0.0f; // pixels, +y up
+
+    bool IsDown(uint32_t mask) const { return (down & mask) != 0; }
+
+    // True when any button in mask is held now and none of them were held before.
+    bool WasPressed(uint32_t mask) const { return (down & mask) != 0 && (previous & mask) == 0; }
+
+    // Builds the next sample from this one, carrying the current buttons over as previous.
+    InputState Next(uint32_t nowDown, float dx = 0.0f, float dy = 0.0f) const {
+        InputState s;
+        s.down        = nowDown;
+        s.previous    = down;
+        s.mouseDeltaX = dx;
+        s.mouseDeltaY = dy;
+        return s;
+    }
+};
+
+#endif // INPUT_STATE_H
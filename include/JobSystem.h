@@ -0,0 +1,97 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Small work-stealing thread pool. Each worker owns a deque: it takes work from the back
+// of its own and steals from the front of the others when it runs dry. The thread that
+// calls ParallelFor helps out until its loop is finished, so a pool with no workers just
+// runs everything inline.
+class JobSystem {
+public:
+    // threads counts the calling thread too; 0 picks one per hardware thread.
+    explicit JobSystem(unsigned threads = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Worker threads plus the caller: the number of distinct thread slots ParallelFor reports.
+    unsigned ThreadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Slot of the calling thread: 1..ThreadCount()-1 on a worker, 0 anywhere else.
+    static unsigned CurrentSlot();
+
+    // Calls fn(begin, end, threadSlot) over [0, count) in chunks of at most grain items and
+    // returns once every chunk has run. threadSlot is CurrentSlot() of the thread running the
+    // chunk, so fn can write per-thread buffers without locking, even when ParallelFor is
+    // called from inside another job. Which thread runs which chunk varies from run to run;
+    // anything order-dependent must be merged afterwards.
+    template <typename Fn>
+    void ParallelFor(size_t count, size_t grain, Fn&& fn) {
+        if (count == 0) return;
+        if (grain == 0) grain = 1;
+        if (workers.empty() || count <= grain) {
+            const unsigned slot = CurrentSlot();
+            for (size_t b = 0; b < count; b += grain) fn(b, std::min(count, b + grain), slot);
+            return;
+        }
+        using F = std::remove_reference_t<Fn>;
+        std::atomic<size_t> remaining{ 0 };
+        Task task;
+        task.run = [](void* ctx, size_t b, size_t e, unsigned slot) { (*static_cast<F*>(ctx))(b, e, slot); };
+        task.ctx = const_cast<void*>(static_cast<const void*>(&fn));
+        task.remaining = &remaining;
+        submit(task, count, grain);
+    }
+
+    // Queues fn(ctx, threadSlot) to run once on whichever thread picks it up; without workers
+    // it runs immediately on the caller. Nothing waits for it: the job reports its own
+    // completion, typically by decrementing a counter that someone passes to HelpUntilZero.
+    void Enqueue(void (*fn)(void* ctx, unsigned slot), void* ctx);
+
+    // Runs queued jobs on the calling thread until counter reads zero.
+    void HelpUntilZero(const std::atomic<size_t>& counter);
+
+private:
+    struct Task {
+        void (*run)(void* ctx, size_t begin, size_t end, unsigned slot) = nullptr; // ParallelFor chunk
+        void (*job)(void* ctx, unsigned slot) = nullptr;                           // or Enqueue job
+        void*                ctx       = nullptr;
+        size_t               begin     = 0;
+        size_t               end       = 0;
+        std::atomic<size_t>* remaining = nullptr; // ParallelFor chunks left, or null for Enqueue jobs
+    };
+    struct Queue {
+        std::mutex       mutex;
+        std::deque<Task> tasks;
+    };
+
+    void submit(const Task& prototype, size_t count, size_t grain);
+    void push(unsigned queue, const Task& task);
+    bool popOwn(unsigned queue, Task& out);
+    bool steal(unsigned thief, Task& out);
+    bool runOne();
+    static void runTask(const Task& task);
+    void workerLoop(unsigned index);
+
+    std::vector<std::unique_ptr<Queue>> queues; // one per worker
+    std::vector<std::thread>            workers;
+    std::atomic<unsigned>               nextQueue{ 0 }; // round-robin target for pushes from outside the pool
+
+    std::mutex              sleepMutex;
+    std::condition_variable wake;
+    std::atomic<size_t>     queued{ 0 };
+    bool                    stopping = false;
+};
+
+#endif // JOB_SYSTEM_H
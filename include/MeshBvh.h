@@ -0,0 +1,54 @@
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Bounding volume hierarchy over a triangle mesh, for segment tests in the mesh's own space.
+// Nodes are laid out depth first in one array: a node's left child comes right after it and
+// only the right child's index is kept, so a walk mostly moves forward through memory.
+// Triangles are stored in leaf order as a corner and two edges, ready for the hit test.
+// Built once; nothing is allocated by a query.
+class MeshBvh {
+public:
+    static constexpr uint32_t kLeafSize = 4; // most triangles a leaf holds
+
+    // Builds from an indexed triangle list (three indices per triangle).
+    void Build(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices);
+    void Clear();
+
+    bool   Empty()         const { return tris.empty(); }
+    size_t TriangleCount() const { return tris.size(); }
+    size_t NodeCount()     const { return nodes.size(); }
+    glm::vec3 BoundsMin() const { return nodes.empty() ? glm::vec3(0.0f) : nodes[0].min; }
+    glm::vec3 BoundsMax() const { return nodes.empty() ? glm::vec3(0.0f) : nodes[0].max; }
+
+    // Whether the segment from a to b touches any triangle, from either side.
+    bool SegmentHits(const glm::vec3& a, const glm::vec3& b) const;
+
+    // The test SegmentHits runs on each triangle it reaches: corner v0, edges e1 and e2.
+    static bool SegmentHitsTriangle(const glm::vec3& a, const glm::vec3& d,
+                                    const glm::vec3& v0, const glm::vec3& e1, const glm::vec3& e2);
+
+private:
+    struct Node {
+        glm::vec3 min;
+        uint32_t  first; // leaf: first triangle; inner: index of the right child
+        glm::vec3 max;
+        uint32_t  count; // triangles in a leaf, 0 for an inner node
+    };
+    struct Triangle {
+        glm::vec3 v0, e1, e2;
+    };
+
+    uint32_t build(std::vector<uint32_t>& order, uint32_t begin, uint32_t end,
+                   const std::vector<glm::vec3>& centroids, const std::vector<glm::vec3>& lo,
+                   const std::vector<glm::vec3>& hi);
+
+    std::vector<Node>     nodes;
+    std::vector<Triangle> tris;
+};
+
+#endif // MESH_BVH_H
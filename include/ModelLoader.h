@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include <cstddef>   
+#include <cstdint>
 #include <glm/glm.hpp>
 
 #include <assimp/scene.h>
@@ -74,4 +75,11 @@ private:
     static unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma=false);
 };
 
+// Positions and triangle indices of every mesh in a model file, read without GL so the
+// simulation can use them with no context. Meshes are concatenated, with indices rebased.
+// With bakeNodeTransforms each mesh is moved by its node's transform, as the node-based
+// Going Merry is drawn; otherwise it stays where Model draws it. False if the file can't be read.
+bool LoadModelTriangles(const std::string& path, bool bakeNodeTransforms,
+                        std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices);
+
 #endif 
@@ -3,6 +3,7 @@
 
 #include <cstring>
 #include "ModelLoader.h"
+#include "MeshBvh.h"
 #include "BoatSkinIds.h"
 #include <glm/glm.hpp>
 #include <assimp/scene.h>
@@ -23,21 +24,47 @@ struct GoingMerryTexture {
 
 class ModelManager {
 public:
+    // Boats are drawn at this scale, with their position's height replaced by the sea level
+    // plus a waterline (except the Going Merry, which floats at its own height).
+    static constexpr float kBoatScale = 5.0f;
+    static constexpr std::array<float, BoatSkinId::COUNT> kPlayerWaterline = { 0.95f, 2.6f, 1.9f, 1.4f, 2.2f, 0.25f };
+    static constexpr float kEnemyWaterline = 0.39f;
+
     ModelManager();
     ~ModelManager();
 
     void LoadAllBoatModels();
 
+    // Collision hulls: a BVH over each boat model's triangles in model space, built once
+    // here. Needs no GL, so the headless simulation gets the same hulls as the window. A
+    // boat whose file can't be read has no hull (null below).
+    void LoadBoatHulls();
+    const MeshBvh* EnemyHull() const { return enemyHull.bvh.Empty() ? nullptr : &enemyHull.bvh; }
+    const MeshBvh* PlayerHull(int boatSkinIndex) const;
+    // Model to world for a hull, the same T * Y * P * R * O * S that DrawEnemyBoat /
+    // DrawPlayerBoat build from these arguments. pitch and roll are in radians with the signs
+    // Buoyancy.h gives them; rotation is a yaw in degrees.
+    glm::mat4 EnemyHullTransform(glm::vec3 position, float rotation, glm::vec3 scale,
+                                 float pitch = 0.0f, float roll = 0.0f) const;
+    glm::mat4 PlayerHullTransform(int boatSkinIndex, glm::vec3 position, float rotation, glm::vec3 scale,
+                                  float pitch = 0.0f, float roll = 0.0f) const;
+    // Radius about the transform's origin that holds the whole hull.
+    static float HullRadius(const MeshBvh& hull, const glm::mat4& transform);
+
     void DrawPlayerBoat(unsigned int shader,
                         int boatSkinIndex,
                         glm::vec3 position,
                         float rotation,
-                        glm::vec3 scale);
+                        glm::vec3 scale,
+                        float pitch = 0.0f,
+                        float roll = 0.0f);
 
     void DrawEnemyBoat(unsigned int shader,
                        glm::vec3 position,
                        float rotation,
-                       glm::vec3 scale);
+                       glm::vec3 scale,
+                       float pitch = 0.0f,
+                       float roll = 0.0f);
 
     void DrawCannonball(unsigned int shader,
                         glm::vec3 position,
@@ -51,6 +78,11 @@ public:
     inline bool ShouldFlipVCannonball() const { return cannonballFlipV; }
 
 private:
+    struct BoatHull {
+        MeshBvh bvh;
+        float   lengthScale = 1.0f; // as computeXZLengthScale gives for the drawn model
+    };
+
     struct NodeMesh {
         std::vector<Vertex>       vertices;
         std::vector<unsigned int> indices;
@@ -75,6 +107,9 @@ private:
     std::unique_ptr<Model> cannonball;
     float                  cannonballUnitScale = 1.0f;
 
+    std::array<BoatHull, BoatSkinId::COUNT> playerHulls;
+    BoatHull                                enemyHull;
+
     const std::vector<std::string> boatModelPaths = {
         "3D Model/thousand_sunny.glb",
         "3D Model/black_beard.glb",
@@ -119,7 +154,14 @@ private:
     bool cannonballFlipV             = false;
 
     static float    computeXZLengthScale(const Model& model);
+    static float    xzLengthScale(const glm::vec3& mn, const glm::vec3& mx);
     static glm::mat4 makeOrient(const EulerOffset& off);
+    static glm::mat4 boatTransform(glm::vec3 position, float rotation, float pitch, float roll,
+                                   const EulerOffset& orient, glm::vec3 scale);
+    // The Going Merry's model runs along +X rather than +Z, and carries no orient offset.
+    static glm::mat4 goingMerryTransform(glm::vec3 position, float rotation, float pitch, float roll);
+    // The skin whose hull stands in for boatSkinIndex, as DrawPlayerBoat picks a model; -1 if none.
+    int hullSkin(int boatSkinIndex) const;
 
     void loadGoingMerryModel();
     void processGoingMerryNode(aiNode* node, const aiScene* scene, const glm::mat4& parentTransform);
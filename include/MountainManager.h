@@ -1,13 +1,19 @@
 #ifndef MOUNTAIN_MANAGER_H
 #define MOUNTAIN_MANAGER_H
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 #include <glm/glm.hpp>
+#include "TimerWheel.h"
 
 extern const float SPAWN_RADIUS_MIN_MOUNTAIN;
 extern const float SPAWN_RADIUS_MAX_MOUNTAIN;
 extern const int   MAX_MOUNTAINS;
 
+class Rng;
+
 struct Mountain {
     glm::vec3 position;
     glm::vec3 scale;
@@ -16,25 +22,70 @@ struct Mountain {
     bool  active;
 };
 
+// Sight lines for MountainManager::checkLineOfSightBatch, as parallel arrays of length
+// count, each from (fromX, fromZ) to (toX, toZ).
+struct SightLines {
+    const float* fromX;
+    const float* fromZ;
+    const float* toX;
+    const float* toZ;
+    uint8_t*     blocked; // out: 1 if a mountain is in the way
+    size_t       count;
+};
+
 class MountainManager {
 public:
     MountainManager();
 
-    void Init();
+    void Init(Rng& rng);
     void Update(float dt, const glm::vec3& playerPosition);
 
   
     const std::vector<Mountain>& GetMountains() const { return mountains; }
 
-    bool checkCollision(glm::vec3 position, float radius);
+    // Replaces the whole set, e.g. to load a fixed layout for benchmarks.
+    void SetMountains(std::vector<Mountain> list);
+
+    bool checkCollision(const glm::vec3& position, float radius) const;
+
+    // Tests many circles in one call. radii holds one radius per position, or a single
+    // radius shared by all of them. outHit[i] becomes 1 if position i overlaps a mountain
+    // (XZ only), else 0. Returns the number of overlapping positions.
+    size_t checkCollisionBatch(std::span<const glm::vec3> positions, std::span<const float> radii,
+                               std::span<uint8_t> outHit) const;
+
+    // Tests many sight lines in one call: a line is blocked if it passes within clearance
+    // of a mountain (XZ only; mountains are taller than anything that flies). Only the
+    // mountains near the lines' bounding box are visited, each against every line at once.
+    // Returns the number of blocked lines.
+    size_t checkLineOfSightBatch(const SightLines& lines, float clearance) const;
+
+    // Earliest t in [0, maxTime] at which a circle of the given radius, starting at origin
+    // and moving with constant velocity, touches a mountain in XZ. maxTime if it never does.
+    float TimeOfImpact(const glm::vec3& origin, const glm::vec3& velocity, float radius, float maxTime) const;
+
+    // Bumped whenever a mountain is added or moved, so cached impact times can be refreshed.
+    uint32_t GetGeneration() const { return generation; }
 
 private:
     void SpawnMountain(const glm::vec3& playerPosition);
     void RepositionFarMountain(Mountain& m, const glm::vec3& playerPosition);
+    void rebuildIndex();
+    bool overlapsAny(float x, float z, float radius) const;
 
     std::vector<Mountain> mountains;
-    float spawnTimer;
+    TimerWheel spawnTimers; // one spawn pending until MAX_MOUNTAINS are up
+    uint32_t tick = 0;
     float spawnInterval;
+    uint32_t generation = 0;
+    Rng*  rng = nullptr; // mountain stream of Game's RandomService
+
+    // Collision index, rebuilt whenever the set changes: active mountains as SoA arrays,
+    // grouped by coarse grid cell (hashed into buckets) so a query only scans nearby ones.
+    std::vector<float>    idxX, idxZ, idxRadius;
+    std::vector<uint32_t> idxBucketStart; // bucket b owns [idxBucketStart[b], idxBucketStart[b+1])
+    uint32_t              idxBucketMask = 0;
+    float                 idxMaxRadius  = 0.0f;
 };
 
 #endif 
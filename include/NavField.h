@@ -0,0 +1,99 @@
+#ifndef NAV_FIELD_H
+#define NAV_FIELD_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MountainManager.h"
+
+// What the field has done since Init, for the headless report.
+struct NavFieldStats {
+    uint64_t solves          = 0; // distance-field solves, at most one per Refresh
+    uint64_t fullRebuilds    = 0; // times every cell was rasterized from scratch
+    uint64_t cellsRasterized = 0; // cells re-tested against the mountains, full rebuilds included
+};
+
+// Square grid over the XZ plane centered on the player's cell, shared by every enemy boat.
+// A cell is blocked if a boat anywhere inside it could touch a mountain. Each solve is one
+// fast-marching pass (Dijkstra ordering with the eikonal update) from the player's cell,
+// giving every reachable cell its path length to the player around the mountains; a boat
+// reads the direction down that field from its own cell instead of pathfinding itself.
+//
+// Blocked flags live in a ring indexed by world cell, so when the player crosses into a
+// new cell only the rows and columns that scroll into view are rasterized, and when the
+// mountains change only the cells around the ones that moved are.
+class NavField {
+public:
+    static constexpr float kUnreachable = std::numeric_limits<float>::infinity();
+
+    // cellsPerSide is rounded up to a power of two. clearance is the boat radius.
+    NavField(int cellsPerSide, float cellSize, float clearance);
+
+    // Forget the current grid; the next Refresh rebuilds it from scratch.
+    void Init();
+    // Re-centers on the player and rasterizes whatever changed since the last call, then
+    // re-solves if anything did. Returns true if it solved.
+    bool Refresh(const glm::vec3& playerPosition, const MountainManager& mountains);
+
+    // Unit XZ direction a boat at position should move in to reach the player around the
+    // mountains. A boat in a blocked cell is pointed to its best open neighbor. False in the
+    // player's own cell, outside the grid, and where the player can't be reached: the
+    // caller steers straight at the player instead.
+    bool Sample(const glm::vec3& position, glm::vec2& direction) const;
+    // Path length from position's cell to the player's, kUnreachable if there is none.
+    float PathDistance(const glm::vec3& position) const;
+
+    // Cell access in grid coordinates, [0, CellsPerSide()) on each axis.
+    int       CellsPerSide() const { return n; }
+    glm::vec3 CellCenter(int x, int z) const;
+    bool      BlockedAt(int x, int z) const { return blocked[ringIndex(originX + x, originZ + z)] != 0; }
+    float     DistanceAt(int x, int z) const { return dist[static_cast<size_t>(z) * n + x]; }
+    float     GetCellSize() const { return cellSize; }
+    float     GetClearance() const { return clearance; }
+
+    const NavFieldStats& GetStats() const { return stats; }
+
+private:
+    // Half-open rectangle of world cells.
+    struct CellRect {
+        int x0, z0, x1, z1;
+    };
+    struct HeapEntry {
+        float    distance;
+        uint32_t cell;
+    };
+
+    int cellOf(float v) const { return static_cast<int>(std::floor(v * invCellSize)); }
+    size_t ringIndex(int wx, int wz) const {
+        return (static_cast<size_t>(static_cast<uint32_t>(wz) & ringMask) << shift) | (static_cast<uint32_t>(wx) & ringMask);
+    }
+    CellRect footprint(const Mountain& m) const;
+    void rasterize(CellRect r);
+    bool restampChangedMountains(const std::vector<Mountain>& current);
+    void solve();
+    float solvedAt(int x, int z) const; // kUnreachable outside the grid or on a blocked cell
+
+    int      n;
+    int      shift;
+    uint32_t ringMask;
+    float    cellSize;
+    float    invCellSize;
+    float    clearance;
+
+    bool     valid = false;
+    int      originX = 0, originZ = 0; // world cell of grid cell (0, 0); the player is at (n/2, n/2)
+    uint32_t mountainGeneration = 0;
+    std::vector<Mountain> stamped;     // the mountains as the blocked flags show them
+
+    std::vector<uint8_t>   blocked;    // ring-indexed by world cell
+    std::vector<float>     dist;       // grid-indexed, z * n + x
+    std::vector<uint8_t>   accepted;   // solve scratch, grid-indexed
+    std::vector<HeapEntry> heap;       // solve scratch
+    std::vector<CellRect>  dirtyRects; // restamp scratch
+    NavFieldStats stats;
+};
+
+#endif // NAV_FIELD_H
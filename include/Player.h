@@ -1,10 +1,11 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include "BoatSkinIds.h"
+#include "Buoyancy.h"
+#include "InputState.h"
+#include "TimerWheel.h"
 
 class ProjectileManager;
 class MountainManager;
@@ -13,9 +14,11 @@ class Player {
 public:
     Player();
 
+    // Ends the tick: advances the player's timers.
     void Update(float dt);
-    void ProcessGameInput(GLFWwindow* window, float dt, ProjectileManager& projectileManager, MountainManager& mountainManager);
-    void Reset();
+    void ProcessGameInput(const InputState& input, float dt, ProjectileManager& projectileManager, MountainManager& mountainManager);
+    // tickSeconds converts the spawn grace period to ticks.
+    void Reset(float tickSeconds = 1.0f / 60.0f);
     void TakeDamage(int damage);
 
     glm::vec3 GetPosition() const { return position; }
@@ -23,6 +26,20 @@ public:
     int       GetHealth()   const { return health; }
     int       GetMaxHealth()const { return maxHealth; }
     const glm::vec3& GetShipFront() const { return shipFront; }
+    // Pose on the waves (see Buoyancy.h), relative to the still water.
+    float     GetHeave() const { return heave; }
+    float     GetPitch() const { return pitch; }
+    float     GetRoll()  const { return roll; }
+    // Moves the pose one step toward the sea under the hull; time is the wave clock in seconds.
+    void      Float(float time, float dt);
+    uint64_t  WaveSampleCount() const { return buoyancy.Samples(); }
+    // Fastest the boat can move in any physics mode, for bounding how soon a shot can reach it.
+    float     GetTopSpeed() const;
+
+    // Transform at the start of the current tick, for interpolated rendering.
+    void      SnapshotTransform() { prevPosition = position; prevRotation = rotation; }
+    glm::vec3 GetInterpolatedPosition(float alpha) const { return prevPosition + (position - prevPosition) * alpha; }
+    float     GetInterpolatedRotation(float alpha) const;
 
     void SetPosition(const glm::vec3& pos) { position = pos; }
     void SetRotation(float rot) { rotation = rot; }
@@ -32,12 +49,18 @@ public:
     void SetPhysicsMode(bool crazyOn);
     void SetBoatSkin(int idx) { boatSkinIndex = idx; }
     void AlignToWater(float waterY);
+    void SetVerbose(bool on) { verbose = on; }
 
 private:
     glm::vec3 position;
     glm::vec3 velocity;
     float rotation;
     glm::vec3 shipFront;
+    glm::vec3 prevPosition;
+    float     prevRotation;
+    float     heave, pitch, roll;
+    float     heaveRate, pitchRate, rollRate;
+    Buoyancy  buoyancy;
 
     float baseSpeed;
     float baseBoost;
@@ -47,11 +70,19 @@ private:
 
     int   health;
     int   maxHealth;
-    float shootCooldown;
-    float gracePeriod;
+    // The gun is reloading while shotTimer is pending, and the player can't be hurt while
+    // graceTimer is.
+    TimerWheel  timers;
+    TimerHandle shotTimer;
+    TimerHandle graceTimer;
+    uint32_t    tick = 0;
+    float       tickSeconds = 1.0f / 60.0f; // dt of the last tick, for TakeDamage
 
     // Current player boat skin index (0..5). 5 = Going Merry.
     int   boatSkinIndex = 0;
+
+    // Damage logging; turned off for headless runs.
+    bool  verbose = true;
 };
 
 #endif 
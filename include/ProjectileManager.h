@@ -1,43 +1,163 @@
 #ifndef PROJECTILE_MANAGER_H
 #define PROJECTILE_MANAGER_H
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
-#include <deque>
+#include "TimerWheel.h"
 
 class MountainManager;
-class ModelManager; 
-
-struct EnhancedProjectile {
-    glm::vec3 position;
-    glm::vec3 velocity;
-    bool active;
-    float lifetime;
-    bool isPlayerOwned;
-    std::vector<glm::vec3> smokeTrail;
-    float smokeTimer;
-    
-    EnhancedProjectile(glm::vec3 pos, glm::vec3 vel, bool playerOwned) 
-        : position(pos), velocity(vel), active(true), lifetime(5.0f), 
-          isPlayerOwned(playerOwned), smokeTimer(0.0f) {}
+class ModelManager;
+
+// Last few smoke puffs behind an enemy shot, stored inline. Once full, each new puff
+// overwrites the oldest one.
+struct SmokeRing {
+    static constexpr int kSlots = 8;
+
+    glm::vec3 points[kSlots];
+    uint8_t   head  = 0; // slot of the oldest puff
+    uint8_t   count = 0;
+
+    void Push(const glm::vec3& p) {
+        if (count < kSlots) {
+            points[(head + count) % kSlots] = p;
+            ++count;
+        } else {
+            points[head] = p;
+            head = static_cast<uint8_t>((head + 1) % kSlots);
+        }
+    }
+    // i = 0 is the oldest puff.
+    const glm::vec3& operator[](int i) const { return points[(head + i) % kSlots]; }
+    int Size() const { return count; }
+};
+
+// Squared distance from p to the segment from a to b.
+inline float SegmentDistance2(const glm::vec3& a, const glm::vec3& b, const glm::vec3& p) {
+    const glm::vec3 d = b - a;
+    const float len2 = glm::dot(d, d);
+    const float t = (len2 > 0.0f) ? std::clamp(glm::dot(p - a, d) / len2, 0.0f, 1.0f) : 0.0f;
+    const glm::vec3 off = a + d * t - p;
+    return glm::dot(off, off);
+}
+
+// Stable name for a projectile. Stays valid until that projectile is removed; after that
+// the slot's generation has moved on and lookups fail instead of hitting a newer shot.
+struct ProjectileHandle {
+    uint32_t slot       = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool IsNull() const { return slot == UINT32_MAX; }
+};
+
+// Fixed-capacity structure-of-arrays projectile pool. Live projectiles are packed into
+// [0, Size()) of every array for dense iteration; removal moves the last one into the
+// hole, so dense order is not preserved. Handles go through a slot table that follows
+// those moves. The arrays are reserved to capacity up front and never reallocate.
+struct ProjectileStore {
+    std::vector<glm::vec3> origin;       // where it was at spawnTime; positions are worked out from there
+    std::vector<glm::vec3> velocity;     // at spawnTime; a ballistic shot's y speed changes from there
+    std::vector<double>    spawnTime;    // ProjectileManager clock when it was added
+    std::vector<uint8_t>   ballistic;    // 1 if it falls under gravity, 0 if it flies straight
+    std::vector<float>     lifetime;
+    std::vector<uint8_t>   playerOwned;
+    std::vector<TimerHandle> expiryTimer; // in ProjectileManager's wheel, once scheduled
+    std::vector<TimerHandle> checkTimer;  // next test against the player, enemy shots only
+    std::vector<double>    expiresAt;    // earliest of mountain impact, splashdown and end of lifetime
+    std::vector<uint8_t>   scheduled;
+    std::vector<uint32_t>  slot;         // dense index -> slot
+
+    size_t Size()      const { return origin.size(); }
+    size_t Capacity()  const { return capacity; }
+    size_t HighWater() const { return highWater; }
+    uint64_t Dropped() const { return dropped; }
+
+    // Empties the pool and sets its capacity. Outstanding handles all become stale.
+    void Reset(size_t capacity);
+    // Null handle (and the shot is counted as dropped) when the pool is full. The shot flies
+    // straight and its spawnTime is 0 until the caller sets them.
+    ProjectileHandle Push(const glm::vec3& pos, const glm::vec3& vel, bool isPlayerOwned);
+    void SwapRemove(size_t i);
+    // Dense index of a live projectile, or -1 if the handle is null or stale.
+    long long IndexOf(ProjectileHandle h) const;
+    ProjectileHandle HandleAt(size_t i) const { return ProjectileHandle{ slot[i], slotGeneration[slot[i]] }; }
+
+private:
+    std::vector<uint32_t> slotGeneration;
+    std::vector<uint32_t> slotDense;     // slot -> dense index while the slot is in use
+    std::vector<uint32_t> freeSlots;     // stack; the next acquire pops from the back
+    size_t   capacity  = 0;
+    size_t   highWater = 0;
+    uint64_t dropped   = 0;
 };
 
 class ProjectileManager {
 public:
     ProjectileManager();
 
-    void Update(float dt, MountainManager& mountainManager);
-    void AddProjectile(glm::vec3 pos, glm::vec3 vel, bool isPlayerOwned, bool clampToWater = true);
-    void Clear();
+    // Empties the pool and sizes it for a match.
+    void Init(size_t capacity);
+    // One tick is Schedule then Integrate, with the same dt. Only Schedule looks at the
+    // mountains; Integrate advances the clock and removes the shots whose expiry timer fires.
+    // Nothing is stepped: a shot's position is worked out from its launch when asked for.
+    void Schedule(float dt, const MountainManager& mountainManager);
+    void Integrate(float dt);
+    // Null handle if the pool is full; the shot is dropped. It flies straight, skimming
+    // the water unless clampToWater is false.
+    ProjectileHandle AddProjectile(glm::vec3 pos, glm::vec3 vel, bool isPlayerOwned, bool clampToWater = true);
+    // Same, for a shell that arcs under gravity and is gone when it falls into the water.
+    ProjectileHandle AddBallistic(const glm::vec3& pos, const glm::vec3& vel, bool isPlayerOwned);
+    // O(1); the last projectile takes index i.
+    void Remove(size_t i);
+    void Clear() { Init(store.Capacity()); }
+
+    // Where projectile i is at the given ProjectileManager time (clamped to its launch).
+    glm::vec3 PositionAt(size_t i, double time) const;
+    glm::vec3 Position(size_t i) const { return PositionAt(i, clock); }
+    // Where it was a tick ago, or its launch point if it was fired since.
+    glm::vec3 PreviousPosition(size_t i) const { return PositionAt(i, clock - tickSeconds); }
+    // alpha of the way through the last tick, for rendering.
+    glm::vec3 InterpolatedPosition(size_t i, float alpha) const {
+        return PositionAt(i, clock - (1.0 - alpha) * tickSeconds);
+    }
+    // The puffs an enemy shot has left behind so far, one where it was every tenth of a
+    // second of its flight; empty for player shots.
+    SmokeRing SmokeTrail(size_t i) const;
+
+    // Enemy shots that came within radius of target over the last tick (the segment from
+    // PreviousPosition to Position), as dense indices in ascending order. Only the shots
+    // whose check has come due are looked at; each one that misses is checked again on the
+    // first tick it could possibly be within radius of a target moving at up to
+    // targetSpeed. Hits are not checked again, so the caller should remove them or hand
+    // them to CheckAgainNextTick.
+    void CollectHitsOnTarget(const glm::vec3& target, float radius, float targetSpeed, std::vector<uint32_t>& hits);
+    // For a shot CollectHitsOnTarget returned that a finer test let through.
+    void CheckAgainNextTick(size_t i);
 
-    
     void DrawAll(unsigned int shader, ModelManager& modelManager);
 
-    const std::vector<EnhancedProjectile>& GetProjectiles() const { return projectiles; }
-    std::vector<EnhancedProjectile>& GetProjectiles() { return projectiles; }
+    const ProjectileStore& GetProjectiles() const { return store; }
+    const TimerWheel& GetTimers() const { return timers; }
 
 private:
-    std::vector<EnhancedProjectile> projectiles;
+    ProjectileHandle add(const glm::vec3& pos, const glm::vec3& vel, bool isPlayerOwned, bool isBallistic);
+    void rescheduleAll(const MountainManager& mountainManager);
+    void schedule(size_t i, const MountainManager& mountainManager);
+    void onTimer(uint64_t tag);
+    float maxSpeed(size_t i) const;
+
+    ProjectileStore store;
+
+    // Expiry and hit-check timers, keyed by Integrate tick and tagged with the
+    // projectile's handle, so a tick costs nothing for shots that have nothing due.
+    TimerWheel timers;
+    double   clock = 0.0;
+    uint32_t tick  = 0;
+    float    tickSeconds = 1.0f / 60.0f;
+    uint32_t scheduledGeneration = 0;
+    std::vector<ProjectileHandle> checkDue; // enemy shots to test against the player next
 };
 
 #endif
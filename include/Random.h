@@ -0,0 +1,74 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// PCG32 (XSH-RR): 16 bytes of state (the LCG state and its stream increment), a handful
+// of instructions per draw, and independent sequences per stream id. Same seed and stream
+// always give the same numbers.
+class Rng {
+public:
+    explicit Rng(uint64_t seed = 0, uint64_t stream = 0) { Seed(seed, stream); }
+
+    void Seed(uint64_t seed, uint64_t stream) {
+        state = 0;
+        inc   = (stream << 1) | 1u;
+        NextU32();
+        state += seed;
+        NextU32();
+    }
+
+    uint32_t NextU32() {
+        const uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        const uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        const uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Uniform in [0, 1) with 24 bits of precision.
+    float NextFloat01() { return static_cast<float>(NextU32() >> 8) * (1.0f / 16777216.0f); }
+    float Range(float lo, float hi) { return lo + (hi - lo) * NextFloat01(); }
+    // Uniform in [lo, hi).
+    int   RangeInt(int lo, int hi) { return lo + static_cast<int>(NextFloat01() * static_cast<float>(hi - lo)); }
+
+    // Batch helpers for spawn sampling.
+    void FillRange(float* out, size_t n, float lo, float hi) {
+        for (size_t i = 0; i < n; ++i) out[i] = Range(lo, hi);
+    }
+    void FillAngles(float* out, size_t n) { FillRange(out, n, 0.0f, 6.28318530717958647692f); }
+
+private:
+    uint64_t state = 0;
+    uint64_t inc   = 1;
+};
+
+// One stream per subsystem, so drawing more numbers in one of them never shifts the others.
+enum class RngStream { ENEMIES, MOUNTAINS, COUNT };
+
+// Owns every simulation random stream; a whole match is reproducible from one seed.
+class RandomService {
+public:
+    void Seed(uint64_t masterSeed) {
+        uint64_t x = masterSeed;
+        for (size_t i = 0; i < streams.size(); ++i) {
+            streams[i].Seed(splitmix64(x), i);
+        }
+    }
+
+    Rng& Stream(RngStream id) { return streams[static_cast<size_t>(id)]; }
+
+private:
+    static uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    std::array<Rng, static_cast<size_t>(RngStream::COUNT)> streams;
+};
+
+#endif // RANDOM_H
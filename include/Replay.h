@@ -0,0 +1,87 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Simulation-relevant input for one tick. Mouse look is quantized to 1/1000 degree
+// before it is applied, so live play and playback apply exactly the same rotation.
+struct TickCommand {
+    uint32_t buttons  = 0; // InputButton bits that drive the player
+    int32_t  yawMilli = 0; // player yaw change this tick, in 1/1000 degree
+
+    bool operator==(const TickCommand& o) const { return buttons == o.buttons && yawMilli == o.yawMilli; }
+    bool operator!=(const TickCommand& o) const { return !(*this == o); }
+};
+
+// Everything besides the per-tick input needed to rebuild a match.
+struct ReplayHeader {
+    uint32_t seed         = 0;
+    uint8_t  difficulty   = 0;
+    uint8_t  boatSkin     = 0;
+    uint8_t  crazyPhysics = 0;
+    uint16_t tickRate     = 60;
+};
+
+// End-of-match state stored after the ticks so playback can check it reproduced the run.
+struct ReplayDigest {
+    uint64_t ticks            = 0;
+    int32_t  score            = 0;
+    int32_t  enemiesDestroyed = 0;
+    int32_t  health           = 0;
+
+    bool operator==(const ReplayDigest& o) const {
+        return ticks == o.ticks && score == o.score && enemiesDestroyed == o.enemiesDestroyed && health == o.health;
+    }
+};
+
+// File layout ("BERP" v1): magic, version, header fields, then runs of identical
+// commands as varint(runLength) varint(buttons ^ previousButtons) varint(zigzag(yawMilli)),
+// a zero run length as terminator, and finally the digest as varints.
+class ReplayRecorder {
+public:
+    void Begin(const ReplayHeader& header);
+    void Record(const TickCommand& cmd);
+    bool Save(const std::string& path, const ReplayDigest& digest);
+
+    bool     IsRecording() const { return recording; }
+    uint64_t TickCount()   const { return ticks; }
+
+private:
+    void flushRun();
+
+    ReplayHeader         header;
+    std::vector<uint8_t> stream;
+    TickCommand          runCmd;
+    uint32_t             lastButtons = 0;
+    uint64_t             runLength   = 0;
+    uint64_t             ticks       = 0;
+    bool                 recording   = false;
+};
+
+class ReplayPlayer {
+public:
+    bool Load(const std::string& path);
+    void Unload() { *this = ReplayPlayer(); }
+
+    // Fetches the next tick's command; false once the recording is exhausted.
+    bool Next(TickCommand& out);
+
+    const ReplayHeader& GetHeader()   const { return header; }
+    const ReplayDigest& GetDigest()   const { return digest; }
+    uint64_t            TicksPlayed() const { return played; }
+    bool                IsLoaded()    const { return loaded; }
+
+private:
+    std::vector<TickCommand> runs;
+    std::vector<uint64_t>    runLengths;
+    ReplayHeader             header;
+    ReplayDigest             digest;
+    size_t                   runIndex     = 0;
+    uint64_t                 runRemaining = 0;
+    uint64_t                 played       = 0;
+    bool                     loaded       = false;
+};
+
+#endif // REPLAY_H
@@ -0,0 +1,95 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Uniform grid over the XZ plane, hashed into a power-of-two bucket table and rebuilt
+// with a counting sort every tick (Begin / Add... / Finalize). Storage is reused between
+// builds, so steady-state rebuilds don't allocate.
+class SpatialHash {
+public:
+    explicit SpatialHash(float cellSize = 4.0f);
+
+    void   SetCellSize(float size) { cellSize = size; invCellSize = 1.0f / size; }
+    float  GetCellSize() const { return cellSize; }
+    size_t Size() const { return entries.size(); }
+
+    void Begin(size_t expectedCount = 0);
+    void Add(uint32_t id, const glm::vec3& position);
+    void Finalize();
+
+    // Calls fn(id, distanceSquared) for every entry within radius of center (XZ only).
+    template <typename Fn>
+    void Query(const glm::vec3& center, float radius, Fn&& fn) const {
+        if (entries.empty()) return;
+        const float r2 = radius * radius;
+        const int x0 = cellOf(center.x - radius), x1 = cellOf(center.x + radius);
+        const int z0 = cellOf(center.z - radius), z1 = cellOf(center.z + radius);
+        for (int cz = z0; cz <= z1; ++cz) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                const uint32_t b = bucketOf(cx, cz);
+                for (uint32_t i = bucketStart[b], end = bucketStart[b + 1]; i < end; ++i) {
+                    const Entry& e = entries[i];
+                    if (e.cx != cx || e.cz != cz) continue; // another cell sharing the bucket
+                    const float dx = e.x - center.x;
+                    const float dz = e.z - center.z;
+                    const float d2 = dx * dx + dz * dz;
+                    if (d2 < r2) fn(e.id, d2);
+                }
+            }
+        }
+    }
+
+    // Like Query, but stops after limit hits; returns how many there were. Which entries
+    // make the cut depends only on the build, so it is deterministic.
+    template <typename Fn>
+    size_t QueryUpTo(const glm::vec3& center, float radius, size_t limit, Fn&& fn) const {
+        size_t hits = 0;
+        if (entries.empty() || limit == 0) return 0;
+        const float r2 = radius * radius;
+        const int x0 = cellOf(center.x - radius), x1 = cellOf(center.x + radius);
+        const int z0 = cellOf(center.z - radius), z1 = cellOf(center.z + radius);
+        for (int cz = z0; cz <= z1; ++cz) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                const uint32_t b = bucketOf(cx, cz);
+                for (uint32_t i = bucketStart[b], end = bucketStart[b + 1]; i < end; ++i) {
+                    const Entry& e = entries[i];
+                    if (e.cx != cx || e.cz != cz) continue;
+                    const float dx = e.x - center.x;
+                    const float dz = e.z - center.z;
+                    const float d2 = dx * dx + dz * dz;
+                    if (d2 >= r2) continue;
+                    fn(e.id, d2);
+                    if (++hits == limit) return hits;
+                }
+            }
+        }
+        return hits;
+    }
+
+private:
+    struct Entry {
+        float    x, z;
+        int32_t  cx, cz;
+        uint32_t id;
+    };
+
+    int cellOf(float v) const { return static_cast<int>(std::floor(v * invCellSize)); }
+    uint32_t bucketOf(int cx, int cz) const {
+        const uint32_t h = static_cast<uint32_t>(cx) * 73856093u ^ static_cast<uint32_t>(cz) * 19349663u;
+        return h & bucketMask;
+    }
+
+    float cellSize;
+    float invCellSize;
+    uint32_t bucketMask = 0;
+
+    std::vector<Entry>    pending;     // unsorted entries added since Begin
+    std::vector<Entry>    entries;     // sorted by bucket after Finalize
+    std::vector<uint32_t> bucketStart; // bucket b owns entries[bucketStart[b], bucketStart[b+1])
+};
+
+#endif // SPATIAL_HASH_H
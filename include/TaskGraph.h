@@ -0,0 +1,77 @@
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+// A fixed set of tasks that each declare which resources they read and write. Tasks are
+// added in the order a single thread would run them. A task waits for every earlier task
+// it conflicts with (either one writes a resource the other reads or writes), and all
+// other tasks may overlap. So a run gives the same result as running them in order, and
+// takes about as long as the longest dependency chain instead of the sum of all tasks.
+class TaskGraph {
+public:
+    using Resources = uint32_t; // one bit per resource; the meaning is up to the caller
+
+    // Returns the task's index.
+    int Add(std::string name, Resources reads, Resources writes, std::function<void()> fn);
+
+    // Runs every task once and returns when all have finished, recording each one's timing.
+    void Run(JobSystem& jobs);
+
+    size_t      Size() const { return nodes.size(); }
+    const char* Name(int task) const { return nodes[task].name.c_str(); }
+    // Timings from the most recent Run, in seconds.
+    double TaskSeconds(int task) const { return nodes[task].end - nodes[task].start; }
+    double WallSeconds() const { return lastWall; }
+    double CriticalPathSeconds() const { return lastCritical; }
+
+    // One line for the most recent Run: wall time, summed task time, and the critical path
+    // (the chain of dependent tasks with the largest total duration) with each step's time.
+    void DumpCriticalPath(std::ostream& out) const;
+
+private:
+    struct Node {
+        std::string           name;
+        Resources             reads  = 0;
+        Resources             writes = 0;
+        std::function<void()> fn;
+        std::vector<int>      predecessors;
+        std::vector<int>      successors;
+        double                start = 0.0, end = 0.0; // seconds since the start of Run
+    };
+    // What Enqueue hands back to runNode.
+    struct Launch {
+        TaskGraph* graph;
+        int        node;
+    };
+
+    static void runNode(void* ctx, unsigned slot);
+    double      secondsSinceStart() const;
+    void        computeCriticalPath();
+
+    std::vector<Node>   nodes;
+    std::vector<Launch> launches;
+    std::vector<int>    criticalPath;
+    // computeCriticalPath's scratch, sized with launches so a Run allocates nothing.
+    std::vector<double> pathFinish;
+    std::vector<int>    pathVia;
+    double              lastWall = 0.0;
+    double              lastCritical = 0.0;
+
+    // State of the Run in progress.
+    std::unique_ptr<std::atomic<int>[]>   waiting;   // unfinished predecessors per node
+    std::atomic<size_t>                   unfinished{ 0 };
+    JobSystem*                            activeJobs = nullptr;
+    std::chrono::steady_clock::time_point runStart;
+};
+
+#endif // TASK_GRAPH_H
@@ -0,0 +1,113 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Stable name for a scheduled timer. Goes stale once the timer fires or is cancelled.
+struct TimerHandle {
+    uint32_t node       = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool IsNull() const { return node == UINT32_MAX; }
+};
+
+// What a wheel has done since its last Reset.
+struct TimerWheelStats {
+    uint64_t scheduled = 0;
+    uint64_t fired     = 0;
+    uint64_t cancelled = 0;
+    uint64_t cascaded  = 0; // times a timer was moved down to a finer level
+};
+
+// Whole ticks closest to seconds at the given tick length, at least one.
+inline uint32_t TicksFor(float seconds, float tickSeconds) {
+    return std::max(1u, static_cast<uint32_t>(std::lround(seconds / tickSeconds)));
+}
+
+// Deadlines keyed by simulation tick, kept in a hierarchical timing wheel: four levels of
+// 64 slots, a slot on each level spanning a whole turn of the level below. A timer sits on
+// the coarsest level where its deadline and the current tick still differ, and moves down
+// when the wheel reaches the start of its slot. Schedule and Cancel are O(1), and Advance
+// costs O(1) per tick plus O(1) for each timer it fires or moves down, so timers that are
+// not due cost nothing however many there are.
+//
+// Timers due on the same tick fire in the order they were scheduled (for deadlines within
+// 2^24 ticks, about three days at 60 Hz; further ones are parked and re-filed). Nothing is
+// locked, so a wheel belongs to whoever advances it.
+class TimerWheel {
+public:
+    TimerWheel();
+
+    // Drops every timer (their handles go stale) and sets the current tick.
+    void Reset(uint32_t tick = 0);
+
+    // tag is handed back to Advance's callback. A deadline at or before Now() fires at the
+    // start of the next Advance.
+    TimerHandle Schedule(uint32_t due, uint64_t tag);
+    // False if the timer has already fired or been cancelled.
+    bool Cancel(TimerHandle h);
+    bool Pending(TimerHandle h) const {
+        return h.node < nodes.size() && nodes[h.node].generation == h.generation && nodes[h.node].list != kNoList;
+    }
+
+    // Moves the wheel forward to tick, calling onExpire(tag) for every timer due by then,
+    // tick by tick. The callback may schedule and cancel timers; one scheduled for the tick
+    // being processed (or earlier) fires later in the same call.
+    template <typename Fn>
+    void Advance(uint32_t tick, Fn&& onExpire) {
+        uint64_t tag;
+        while (popReady(tag)) onExpire(tag);
+        while (static_cast<int32_t>(tick - now) > 0) {
+            if (pending == 0) {
+                now = tick;
+                break;
+            }
+            beginTick(now + 1);
+            while (popReady(tag)) onExpire(tag);
+        }
+    }
+
+    uint32_t Now() const { return now; }
+    size_t   Size() const { return pending; }
+    const TimerWheelStats& GetStats() const { return stats; }
+
+private:
+    static constexpr int      kLevels   = 4;
+    static constexpr int      kSlotBits = 6;
+    static constexpr uint32_t kSlots    = 1u << kSlotBits;
+    static constexpr uint32_t kSlotMask = kSlots - 1;
+    static constexpr uint32_t kReadyList = kLevels * kSlots; // due now, fired by the next Advance
+    static constexpr uint32_t kNoList   = UINT32_MAX;
+    static constexpr uint32_t kNil      = UINT32_MAX;
+
+    struct Node {
+        uint64_t tag;
+        uint32_t due;
+        uint32_t generation = 0;
+        uint32_t list = kNoList;  // which slot list it is in; kNoList while free
+        uint32_t prev = kNil, next = kNil;
+    };
+    struct List {
+        uint32_t head = kNil, tail = kNil;
+    };
+
+    void place(uint32_t node);
+    void append(uint32_t list, uint32_t node);
+    void unlink(uint32_t node);
+    void release(uint32_t node);
+    void beginTick(uint32_t tick);
+    bool popReady(uint64_t& tag);
+
+    std::vector<Node>     nodes;
+    std::vector<uint32_t> freeNodes;
+    std::vector<List>     lists;     // level * kSlots + slot, then the ready list
+    uint32_t now     = 0;
+    size_t   pending = 0;
+    TimerWheelStats stats;
+};
+
+#endif // TIMER_WHEEL_H
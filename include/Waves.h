@@ -0,0 +1,47 @@
+#ifndef WAVES_H
+#define WAVES_H
+
+#include <cstddef>
+
+// The sea surface the water shader draws (Graphics::createShaderProgram): three travelling
+// sines in world XZ, summed, scaled by kWaveAmplitude and added to the still water level.
+// The shader takes kWaveAmplitude and kWaveSpeed as its waterAmp and waterSpeed uniforms;
+// the frequencies, heights and phase speeds below are written out in it as well.
+constexpr float kWaveAmplitude = 0.10f;
+constexpr float kWaveSpeed     = 1.0f;
+
+struct WaveTerm {
+    float alongX, alongZ; // the term runs along (x * alongX + z * alongZ)
+    float frequency;      // radians per unit
+    float height;         // before kWaveAmplitude
+    float phaseSpeed;     // radians per second of wave time
+};
+constexpr WaveTerm kWaveTerms[3] = {
+    { 1.0f, 0.0f, 0.06f, 1.2f, 1.3f },
+    { 0.0f, 1.0f, 0.10f, 0.6f, 1.7f },
+    { 1.0f, 1.0f, 0.03f, 0.4f, 0.9f },
+};
+
+// Points to sample, all of length count.
+struct WaveSamples {
+    const float* x;
+    const float* z;
+    float*       height; // out: world y of the surface
+    size_t       count;
+};
+
+// The surface height under every point at time (seconds, the clock Graphics passes as
+// waveTime). sin is a polynomial after range reduction, good to a few 1e-6 of an
+// amplitude; every path does the same operations, so they agree bit for bit.
+void SampleWaveHeights(const WaveSamples& s, float time);
+
+// Plain C++ version used without SSE. Produces bit-identical results to the SIMD paths.
+void SampleWaveHeightsScalar(const WaveSamples& s, float time);
+
+// One point, the same numbers as the batched call.
+float WaveHeight(float x, float z, float time);
+
+// Which path SampleWaveHeights takes in this build: "avx", "sse2" or "scalar".
+const char* WaveSamplePath();
+
+#endif // WAVES_H
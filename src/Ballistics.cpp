@@ -0,0 +1,90 @@
+#include "Ballistics.h"
+#include <algorithm>
+#include <cmath>
+
+// Rounds of aim-point refinement after the flat-shot lead, then Newton steps on the exact
+// intercept condition. The rounds land near the low arc's root, so Newton stays on it.
+static constexpr int   kInterceptRounds = 3;
+static constexpr int   kNewtonSteps     = 4;
+static constexpr float kRootTolerance   = 1e-3f; // of |q(t)| against (s t)^2
+
+float TimeToFall(float y0, float vy, float y) {
+    const float disc = vy * vy + 2.0f * kGravity * (y0 - y);
+    if (disc < 0.0f) return 0.0f; // never gets up to y
+    return std::max(0.0f, (vy + std::sqrt(disc)) / kGravity);
+}
+
+// Earliest t > 0 with |d + v t| = s t in XZ, or the straight-line time if the target
+// outruns the shell.
+static float flatLead(float dx, float dz, float vx, float vz, float s) {
+    const float c = dx * dx + dz * dz;
+    const float straight = std::sqrt(c) / s;
+    const float a = vx * vx + vz * vz - s * s;
+    const float b = dx * vx + dz * vz; // half the linear term
+    if (std::fabs(a) < 1e-6f) return (b < 0.0f) ? -0.5f * c / b : straight;
+    const float disc = b * b - a * c;
+    if (disc < 0.0f) return straight;
+    const float root = std::sqrt(disc);
+    const float t0 = (-b - root) / a, t1 = (-b + root) / a;
+    const float t = (t0 > 0.0f && (t0 < t1 || t1 <= 0.0f)) ? t0 : t1;
+    return (t > 0.0f) ? t : straight;
+}
+
+size_t SolveIntercepts(const InterceptArrays& a, const InterceptParams& p) {
+    const float s = p.muzzleSpeed, s2 = s * s, g = kGravity;
+    const float vx = p.targetVelX, vz = p.targetVelZ;
+    const float kHalfSqrt2 = 0.70710678f;
+    size_t reachable = 0;
+    for (size_t i = 0; i < a.count; ++i) {
+        const float dx = p.targetX - a.fromX[i];
+        const float dy = p.targetY - a.fromY[i];
+        const float dz = p.targetZ - a.fromZ[i];
+
+        // Guess: the aim point's low-arc flight time, with the aim point moved to match.
+        float t = flatLead(dx, dz, vx, vz, s);
+        float aimX = dx, aimZ = dz, range = 1.0f, cosE = 1.0f;
+        for (int round = 0; round < kInterceptRounds; ++round) {
+            aimX = dx + vx * t;
+            aimZ = dz + vz * t;
+            range = std::max(std::sqrt(aimX * aimX + aimZ * aimZ), 1e-4f);
+            const float disc = s2 * s2 - g * (g * range * range + 2.0f * dy * s2);
+            if (disc >= 0.0f) {
+                const float tanE = (s2 - std::sqrt(disc)) / (g * range);
+                cosE = 1.0f / std::sqrt(1.0f + tanE * tanE);
+            } else {
+                cosE = kHalfSqrt2;
+            }
+            t = range / (s * cosE);
+        }
+
+        // Polish: the shell meets the target at t exactly when
+        //   q(t) = g^2/4 t^4 + (|v|^2 + g dy - s^2) t^2 + 2 (d.v) t + |d|^2 = 0.
+        const float c4 = 0.25f * g * g, c2 = vx * vx + vz * vz + g * dy - s2;
+        const float c1 = 2.0f * (dx * vx + dz * vz), c0 = dx * dx + dy * dy + dz * dz;
+        for (int step = 0; step < kNewtonSteps; ++step) {
+            const float q  = ((c4 * t * t + c2) * t + c1) * t + c0;
+            const float dq = (4.0f * c4 * t * t + 2.0f * c2) * t + c1;
+            if (dq == 0.0f) break;
+            t = std::max(t - q / dq, 1e-3f);
+        }
+        const float q = ((c4 * t * t + c2) * t + c1) * t + c0;
+        const bool in = std::fabs(q) <= kRootTolerance * s2 * t * t;
+
+        if (in) {
+            // The launch velocity that gets to the target's position at t.
+            const float inv = 1.0f / t;
+            a.velX[i] = (dx + vx * t) * inv;
+            a.velY[i] = (dy + 0.5f * g * t * t) * inv;
+            a.velZ[i] = (dz + vz * t) * inv;
+        } else {
+            const float flat = s * kHalfSqrt2 / range;
+            a.velX[i] = aimX * flat;
+            a.velY[i] = s * kHalfSqrt2;
+            a.velZ[i] = aimZ * flat;
+        }
+        a.flightTime[i] = t;
+        a.inRange[i] = in ? 1 : 0;
+        reachable += in ? 1 : 0;
+    }
+    return reachable;
+}
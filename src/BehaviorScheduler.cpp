@@ -0,0 +1,84 @@
+#include "BehaviorScheduler.h"
+#include <algorithm>
+
+uint32_t BehaviorScheduler::Start(BehaviorTask task) {
+    uint32_t id;
+    if (!freeSlots.empty()) {
+        id = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        id = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+    slots[id].handle = task.Release();
+    slots[id].waitingSignal = false;
+    ++live;
+    schedule(id, now);
+    return id;
+}
+
+void BehaviorScheduler::Stop(uint32_t id) {
+    if (id >= slots.size() || !slots[id].handle) return;
+    slots[id].handle.destroy();
+    release(id);
+}
+
+void BehaviorScheduler::StopAll() {
+    for (uint32_t id = 0; id < slots.size(); ++id) Stop(id);
+}
+
+void BehaviorScheduler::Reset(uint32_t tick) {
+    StopAll();
+    now = tick;
+    timers.Reset(tick);
+}
+
+void BehaviorScheduler::RunUntil(uint32_t tick) {
+    now = tick;
+    timers.Advance(tick, [this](uint64_t id) { resume(static_cast<uint32_t>(id)); });
+}
+
+void BehaviorScheduler::Signal(uint32_t id) {
+    if (id >= slots.size() || !slots[id].handle || !slots[id].waitingSignal) return;
+    slots[id].waitingSignal = false;
+    --waitingSignal;
+    resume(id);
+}
+
+void BehaviorScheduler::schedule(uint32_t id, uint32_t due) {
+    slots[id].sleep = timers.Schedule(due, id);
+}
+
+void BehaviorScheduler::sleepCurrent(uint32_t ticks) {
+    schedule(current, now + std::max(ticks, 1u));
+}
+
+void BehaviorScheduler::waitCurrent() {
+    slots[current].waitingSignal = true;
+    ++waitingSignal;
+}
+
+// A task may Signal another from inside itself, so the caller's current id is put back.
+void BehaviorScheduler::resume(uint32_t id) {
+    const uint32_t caller = current;
+    const std::coroutine_handle<> h = slots[id].handle;
+    current = id;
+    ++resumes;
+    h.resume();
+    current = caller;
+    if (h.done()) {
+        h.destroy();
+        release(id);
+    }
+}
+
+void BehaviorScheduler::release(uint32_t id) {
+    Slot& s = slots[id];
+    if (s.waitingSignal) --waitingSignal;
+    timers.Cancel(s.sleep);
+    s.handle = {};
+    s.sleep = {};
+    s.waitingSignal = false;
+    --live;
+    freeSlots.push_back(id);
+}
@@ -0,0 +1,1536 @@
+#include "Benchmarks.h"
+#include "SpatialHash.h"
+#include "MountainManager.h"
+#include "ProjectileManager.h"
+#include "EnemyKernel.h"
+#include "Flocking.h"
+#include "NavField.h"
+#include "BehaviorScheduler.h"
+#include "TimerWheel.h"
+#include "Ballistics.h"
+#include "MeshBvh.h"
+#include "Waves.h"
+#include "Buoyancy.h"
+#include "JobSystem.h"
+#include "Random.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using BenchClock = std::chrono::steady_clock;
+
+static double elapsedSeconds(BenchClock::time_point since) {
+    return std::chrono::duration<double>(BenchClock::now() - since).count();
+}
+
+// Points spread so the average density matches a crowded HARD match (~1 boat per 50 m^2).
+static std::vector<glm::vec3> scatterPoints(Rng& rng, size_t n) {
+    const float half = std::sqrt(static_cast<float>(n) * 50.0f) * 0.5f;
+    std::vector<glm::vec3> pts(n);
+    for (auto& p : pts) p = glm::vec3(rng.Range(-half, half), -1.0f, rng.Range(-half, half));
+    return pts;
+}
+
+static bool checkBroadphaseOracle() {
+    Rng rng(1234, 1);
+    SpatialHash grid(4.0f);
+    for (size_t n : { size_t(0), size_t(1), size_t(37), size_t(500), size_t(4000) }) {
+        const std::vector<glm::vec3> pts = scatterPoints(rng, n);
+        grid.Begin(n);
+        for (size_t i = 0; i < n; ++i) grid.Add(static_cast<uint32_t>(i), pts[i]);
+        grid.Finalize();
+
+        const std::vector<glm::vec3> queries = scatterPoints(rng, 300);
+        std::vector<uint32_t> got, want;
+        for (const auto& q : queries) {
+            const float radius = rng.Range(0.1f, 9.0f);
+            got.clear();
+            want.clear();
+            grid.Query(q, radius, [&](uint32_t id, float) { got.push_back(id); });
+            for (size_t i = 0; i < n; ++i) {
+                const float dx = pts[i].x - q.x, dz = pts[i].z - q.z;
+                if (dx * dx + dz * dz < radius * radius) want.push_back(static_cast<uint32_t>(i));
+            }
+            std::sort(got.begin(), got.end());
+            if (got != want) {
+                std::cout << "broadphase oracle MISMATCH: n=" << n << " radius=" << radius
+                          << " got " << got.size() << " want " << want.size() << "\n";
+                return false;
+            }
+        }
+    }
+    std::cout << "broadphase oracle: OK\n";
+    return true;
+}
+
+static void benchBroadphase() {
+    Rng rng(99, 2);
+    SpatialHash grid(4.0f);
+    const float hitRadius = 2.0f;
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "     entities   queries   build(ms)   query(ms)   brute(ms)   hits\n";
+    for (size_t n : { size_t(100), size_t(1000), size_t(10000), size_t(100000) }) {
+        const std::vector<glm::vec3> pts = scatterPoints(rng, n);
+        const std::vector<glm::vec3> queries = scatterPoints(rng, std::max<size_t>(n / 4, 1));
+
+        BenchClock::time_point t = BenchClock::now();
+        grid.Begin(n);
+        for (size_t i = 0; i < n; ++i) grid.Add(static_cast<uint32_t>(i), pts[i]);
+        grid.Finalize();
+        const double buildMs = elapsedSeconds(t) * 1e3;
+
+        size_t hits = 0;
+        t = BenchClock::now();
+        for (const auto& q : queries) grid.Query(q, hitRadius, [&](uint32_t, float) { ++hits; });
+        const double queryMs = elapsedSeconds(t) * 1e3;
+
+        // The O(P*E) scan checkCollisions used to do; skipped where it would take minutes.
+        double bruteMs = -1.0;
+        if (n <= 10000) {
+            size_t bruteHits = 0;
+            t = BenchClock::now();
+            for (const auto& q : queries) {
+                for (const auto& p : pts) {
+                    const float dx = p.x - q.x, dz = p.z - q.z;
+                    if (dx * dx + dz * dz < hitRadius * hitRadius) ++bruteHits;
+                }
+            }
+            bruteMs = elapsedSeconds(t) * 1e3;
+            if (bruteHits != hits) std::cout << "  (hit count mismatch: " << bruteHits << ")\n";
+        }
+
+        std::cout << std::setw(13) << n << std::setw(10) << queries.size()
+                  << std::setw(12) << buildMs << std::setw(12) << queryMs;
+        if (bruteMs >= 0.0) std::cout << std::setw(12) << bruteMs;
+        else                std::cout << std::setw(12) << "-";
+        std::cout << std::setw(7) << hits << "\n";
+    }
+}
+
+// Mountains at the game's sizes, spaced like the spawner spaces them (~one per 100 m square).
+static std::vector<Mountain> scatterMountains(Rng& rng, size_t n) {
+    const float half = std::sqrt(static_cast<float>(n) * 10000.0f) * 0.5f;
+    std::vector<Mountain> list(n);
+    for (auto& m : list) {
+        const float s = rng.Range(10.0f, 20.0f);
+        m.position = glm::vec3(rng.Range(-half, half), -1.0f, rng.Range(-half, half));
+        m.scale = glm::vec3(s);
+        m.radius = 3.0f * s;
+        m.textureIndex = 0;
+        m.active = rng.NextFloat01() < 0.95f;
+    }
+    return list;
+}
+
+// The linear scan checkCollision used to do.
+static bool bruteMountainHit(const std::vector<Mountain>& list, const glm::vec3& p, float r) {
+    for (const auto& m : list) {
+        if (!m.active) continue;
+        const float dx = p.x - m.position.x, dz = p.z - m.position.z;
+        const float rr = r + m.radius;
+        if (dx * dx + dz * dz < rr * rr) return true;
+    }
+    return false;
+}
+
+// The linear scan TimeOfImpact used to do.
+static float bruteTimeOfImpact(const std::vector<Mountain>& list, const glm::vec3& o, const glm::vec3& v, float r,
+                               float maxTime) {
+    const float a = v.x * v.x + v.z * v.z;
+    float best = maxTime;
+    for (const auto& m : list) {
+        if (!m.active) continue;
+        const float rr = r + m.radius;
+        const float dx = o.x - m.position.x, dz = o.z - m.position.z;
+        const float c = dx * dx + dz * dz - rr * rr;
+        if (c < 0.0f) return 0.0f;
+        if (a <= 0.0f) continue;
+        const float b = dx * v.x + dz * v.z;
+        if (b >= 0.0f) continue;
+        const float disc = b * b - a * c;
+        if (disc < 0.0f) continue;
+        best = std::min(best, (-b - std::sqrt(disc)) / a);
+    }
+    return best;
+}
+
+static bool checkMountainOracle() {
+    Rng rng(4321, 3);
+    MountainManager mountains;
+    for (size_t n : { size_t(0), size_t(6), size_t(33), size_t(500), size_t(5000) }) {
+        const std::vector<Mountain> list = scatterMountains(rng, n);
+        mountains.SetMountains(list);
+
+        const float half = std::sqrt(static_cast<float>(std::max<size_t>(n, 1)) * 10000.0f) * 0.5f + 80.0f;
+        std::vector<glm::vec3> points(2000);
+        std::vector<float> radii(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            points[i] = glm::vec3(rng.Range(-half, half), -1.0f, rng.Range(-half, half));
+            radii[i] = rng.Range(0.5f, 80.0f);
+        }
+        std::vector<uint8_t> hits(points.size());
+        mountains.checkCollisionBatch(points, radii, hits);
+        for (size_t i = 0; i < points.size(); ++i) {
+            const bool want = bruteMountainHit(list, points[i], radii[i]);
+            if (static_cast<bool>(hits[i]) != want || mountains.checkCollision(points[i], radii[i]) != want) {
+                std::cout << "mountain oracle MISMATCH: n=" << n << " point " << i << " radius " << radii[i]
+                          << " want " << want << "\n";
+                return false;
+            }
+        }
+        // Shots crossing the field: slow and fast, short and long flights, some standing still.
+        for (size_t i = 0; i < points.size(); ++i) {
+            const float speed = (i % 13 == 0) ? 0.0f : rng.Range(5.0f, 40.0f);
+            const float heading = rng.Range(0.0f, 6.2831853f);
+            const glm::vec3 v(std::cos(heading) * speed, 0.0f, std::sin(heading) * speed);
+            const float maxTime = (i % 5 == 0) ? rng.Range(10.0f, 60.0f) : rng.Range(0.0f, 4.0f);
+            const float r = rng.Range(0.1f, 2.0f);
+            const float want = bruteTimeOfImpact(list, points[i], v, r, maxTime);
+            const float got = mountains.TimeOfImpact(points[i], v, r, maxTime);
+            if (got != want) {
+                std::cout << "impact oracle MISMATCH: n=" << n << " shot " << i << " got " << got << " want " << want
+                          << "\n";
+                return false;
+            }
+        }
+    }
+    std::cout << "mountain oracle: OK (overlaps and impact times)\n";
+    return true;
+}
+
+static void benchMountains() {
+    Rng rng(77, 4);
+    MountainManager mountains;
+    const float boatRadius = 1.0f;
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "    mountains   queries   batch(ms)   brute(ms)   hits\n";
+    for (size_t n : { size_t(6), size_t(100), size_t(1000), size_t(10000) }) {
+        const std::vector<Mountain> list = scatterMountains(rng, n);
+        mountains.SetMountains(list);
+
+        const float half = std::sqrt(static_cast<float>(n) * 10000.0f) * 0.5f;
+        std::vector<glm::vec3> points(20000);
+        for (auto& p : points) p = glm::vec3(rng.Range(-half, half), -1.0f, rng.Range(-half, half));
+        std::vector<uint8_t> hits(points.size());
+
+        BenchClock::time_point t = BenchClock::now();
+        const size_t batchHits = mountains.checkCollisionBatch(points, std::span<const float>(&boatRadius, 1), hits);
+        const double batchMs = elapsedSeconds(t) * 1e3;
+
+        size_t bruteHits = 0;
+        t = BenchClock::now();
+        for (const auto& p : points) bruteHits += bruteMountainHit(list, p, boatRadius);
+        const double bruteMs = elapsedSeconds(t) * 1e3;
+        if (bruteHits != batchHits) std::cout << "  (hit count mismatch: " << bruteHits << ")\n";
+
+        std::cout << std::setw(13) << n << std::setw(10) << points.size()
+                  << std::setw(12) << batchMs << std::setw(12) << bruteMs << std::setw(7) << batchHits << "\n";
+    }
+}
+
+// Sight lines from a ring of shooters to one target, as EnemyManager casts them.
+struct SightLineSet {
+    std::vector<float>   fromX, fromZ, toX, toZ;
+    std::vector<uint8_t> blocked;
+
+    SightLineSet(Rng& rng, size_t n, float half) : fromX(n), fromZ(n), toX(n), toZ(n), blocked(n) {
+        const float tx = rng.Range(-half, half), tz = rng.Range(-half, half);
+        for (size_t k = 0; k < n; ++k) {
+            const float a = rng.Range(0.0f, 6.2831853f), d = rng.Range(5.0f, 60.0f);
+            fromX[k] = tx + std::cos(a) * d;
+            fromZ[k] = tz + std::sin(a) * d;
+            toX[k] = tx;
+            toZ[k] = tz;
+        }
+    }
+    SightLines View() { return SightLines{ fromX.data(), fromZ.data(), toX.data(), toZ.data(), blocked.data(), fromX.size() }; }
+};
+
+// Distance from a mountain's center to sight line k, in double, minus the blocking
+// distance: negative means blocked.
+static double sightMargin(const SightLineSet& s, size_t k, const Mountain& m, float clearance) {
+    const double ax = s.fromX[k], az = s.fromZ[k], dx = s.toX[k] - ax, dz = s.toZ[k] - az;
+    const double len2 = dx * dx + dz * dz;
+    const double t = len2 > 0.0 ? std::clamp(((m.position.x - ax) * dx + (m.position.z - az) * dz) / len2, 0.0, 1.0) : 0.0;
+    const double px = ax + t * dx - m.position.x, pz = az + t * dz - m.position.z;
+    return std::sqrt(px * px + pz * pz) - (m.radius + clearance);
+}
+
+static bool checkLineOfSightOracle() {
+    Rng rng(2718, 5);
+    MountainManager mountains;
+    const float clearance = 0.5f;
+    size_t lines = 0, blocked = 0, edge = 0;
+    for (size_t n : { size_t(0), size_t(6), size_t(33), size_t(500) }) {
+        const std::vector<Mountain> list = scatterMountains(rng, n);
+        mountains.SetMountains(list);
+        const float half = std::sqrt(static_cast<float>(std::max<size_t>(n, 1)) * 10000.0f) * 0.5f;
+        for (size_t count : { size_t(1), size_t(7), size_t(200) }) {
+            SightLineSet set(rng, count, half);
+            const size_t got = mountains.checkLineOfSightBatch(set.View(), clearance);
+            size_t want = 0;
+            for (size_t k = 0; k < count; ++k) {
+                double margin = 1e9;
+                for (const Mountain& m : list)
+                    if (m.active) margin = std::min(margin, sightMargin(set, k, m, clearance));
+                want += margin < 0.0;
+                if (std::fabs(margin) < 1e-3) { ++edge; continue; }
+                if ((set.blocked[k] != 0) != (margin < 0.0)) {
+                    std::cout << "line of sight oracle MISMATCH: " << n << " mountains, line " << k << " of " << count
+                              << " blocked " << int(set.blocked[k]) << ", margin " << margin << "\n";
+                    return false;
+                }
+            }
+            if (edge == 0 && got != want) {
+                std::cout << "line of sight oracle MISMATCH: " << got << " blocked, want " << want << "\n";
+                return false;
+            }
+            lines += count;
+            blocked += got;
+        }
+    }
+    std::cout << "line of sight oracle: OK (" << blocked << " of " << lines << " lines blocked, " << edge
+              << " grazing skipped)\n";
+    return true;
+}
+
+// A tick's worth of sight lines against a growing world: the batched query against
+// testing every line against every mountain.
+static void benchLineOfSight() {
+    Rng rng(1618, 6);
+    MountainManager mountains;
+    const float clearance = 0.5f;
+    std::cout << std::fixed << std::setprecision(3)
+              << "    mountains   lines   batch(us)   brute(us)   blocked\n";
+    for (size_t n : { size_t(6), size_t(100), size_t(1000) }) {
+        const std::vector<Mountain> list = scatterMountains(rng, n);
+        mountains.SetMountains(list);
+        const float half = std::sqrt(static_cast<float>(n) * 10000.0f) * 0.5f;
+        for (size_t count : { size_t(16), size_t(256) }) {
+            SightLineSet set(rng, count, half);
+            const int reps = 2000;
+            size_t got = 0;
+            BenchClock::time_point t = BenchClock::now();
+            for (int r = 0; r < reps; ++r) got = mountains.checkLineOfSightBatch(set.View(), clearance);
+            const double batchUs = elapsedSeconds(t) * 1e6 / reps;
+
+            size_t brute = 0;
+            t = BenchClock::now();
+            for (int r = 0; r < reps; ++r) {
+                brute = 0;
+                for (size_t k = 0; k < count; ++k) {
+                    bool hit = false;
+                    for (const Mountain& m : list) hit |= m.active && sightMargin(set, k, m, clearance) < 0.0;
+                    brute += hit;
+                }
+            }
+            const double bruteUs = elapsedSeconds(t) * 1e6 / reps;
+            std::cout << std::setw(13) << n << std::setw(8) << count << std::setw(12) << batchUs
+                      << std::setw(12) << bruteUs << std::setw(10) << got << (brute != got ? " (brute differs)" : "") << "\n";
+        }
+    }
+}
+
+// Random acquire/release against a plain list of what should be alive. Each projectile
+// carries its id in velocity.x so a handle resolving to the wrong one is caught.
+static bool checkProjectilePoolOracle() {
+    Rng rng(555, 5);
+    ProjectileStore pool;
+    pool.Reset(300);
+    struct Live { ProjectileHandle handle; float id; };
+    std::vector<Live> live;
+    std::vector<ProjectileHandle> stale;
+
+    for (int step = 0; step < 200000; ++step) {
+        if (rng.NextFloat01() < 0.52f) {
+            const float id = static_cast<float>(step);
+            const ProjectileHandle h = pool.Push(glm::vec3(0.0f), glm::vec3(id, 0.0f, 0.0f), false);
+            if (h.IsNull() != (live.size() == pool.Capacity())) {
+                std::cout << "projectile pool oracle MISMATCH: acquire at size " << live.size() << "\n";
+                return false;
+            }
+            if (!h.IsNull()) live.push_back(Live{ h, id });
+        } else if (!live.empty()) {
+            const size_t k = static_cast<size_t>(rng.RangeInt(0, static_cast<int>(live.size())));
+            pool.SwapRemove(static_cast<size_t>(pool.IndexOf(live[k].handle)));
+            stale.push_back(live[k].handle);
+            live[k] = live.back();
+            live.pop_back();
+        }
+        if (step % 97 != 0) continue;
+
+        if (pool.Size() != live.size()) {
+            std::cout << "projectile pool oracle MISMATCH: size " << pool.Size() << " want " << live.size() << "\n";
+            return false;
+        }
+        for (const Live& l : live) {
+            const long long i = pool.IndexOf(l.handle);
+            if (i < 0 || pool.velocity[static_cast<size_t>(i)].x != l.id) {
+                std::cout << "projectile pool oracle MISMATCH: live handle lost at step " << step << "\n";
+                return false;
+            }
+        }
+        for (const ProjectileHandle& h : stale) {
+            if (pool.IndexOf(h) >= 0) {
+                std::cout << "projectile pool oracle MISMATCH: stale handle resolved at step " << step << "\n";
+                return false;
+            }
+        }
+        if (stale.size() > 1000) stale.erase(stale.begin(), stale.begin() + 500);
+    }
+    std::cout << "projectile pool oracle: OK (high-water " << pool.HighWater() << ", "
+              << pool.Dropped() << " dropped)\n";
+    return true;
+}
+
+static void benchProjectilePool() {
+    ProjectileStore pool;
+    std::cout << std::fixed << std::setprecision(3) << "     capacity   cycles   ns/acquire+release\n";
+    for (size_t capacity : { size_t(256), size_t(4096), size_t(65536) }) {
+        pool.Reset(capacity);
+        std::vector<ProjectileHandle> handles(capacity);
+        const size_t cycles = 2000000;
+        for (size_t i = 0; i < capacity; ++i) handles[i] = pool.Push(glm::vec3(0.0f), glm::vec3(1.0f), true);
+        BenchClock::time_point t = BenchClock::now();
+        for (size_t c = 0; c < cycles; ++c) {
+            const size_t k = (c * 2654435761u) % capacity;
+            pool.SwapRemove(static_cast<size_t>(pool.IndexOf(handles[k])));
+            handles[k] = pool.Push(glm::vec3(0.0f), glm::vec3(1.0f), true);
+        }
+        const double ns = elapsedSeconds(t) * 1e9 / static_cast<double>(cycles);
+        std::cout << std::setw(13) << capacity << std::setw(9) << cycles << std::setw(21) << ns << "\n";
+    }
+}
+
+// Enemy arrays for the steering kernel, filled like a busy match around a player at the origin.
+// Every fifth boat is stepped four ticks at a time, like a mid-range boat under AI LOD.
+struct SteerArrays {
+    std::vector<float>   x, y, z, faceX, faceZ, dt;
+    std::vector<uint8_t> armed, active, fire;
+
+    SteerArrays(Rng& rng, size_t n) : x(n), y(n), z(n), faceX(n), faceZ(n), dt(n), armed(n), active(n), fire(n) {
+        for (size_t i = 0; i < n; ++i) {
+            const float r = (i % 17 == 0) ? rng.Range(0.0f, 6.0f) : rng.Range(0.0f, 110.0f);
+            const float a = rng.Range(0.0f, 6.2831853f);
+            x[i] = r * std::cos(a);
+            y[i] = -1.0f;
+            z[i] = r * std::sin(a);
+            armed[i] = rng.NextFloat01() < 0.3f;
+            faceX[i] = 0.0f;
+            faceZ[i] = 1.0f;
+            dt[i] = (i % 5 == 0) ? 4.0f / 60.0f : 1.0f / 60.0f;
+            active[i] = rng.NextFloat01() < 0.9f;
+        }
+        if (n > 5) { x[5] = 0.0f; y[5] = -0.45f; z[5] = 0.0f; } // exactly on the player
+    }
+    EnemySteerArrays View() {
+        return EnemySteerArrays{ x.data(), y.data(), z.data(), armed.data(), faceX.data(), faceZ.data(),
+                                 dt.data(), active.data(), fire.data(), x.size() };
+    }
+    bool BitEqual(const SteerArrays& o) const {
+        auto same = [](const auto& a, const auto& b) {
+            return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(a[0])) == 0);
+        };
+        return same(x, o.x) && same(y, o.y) && same(z, o.z) &&
+               same(faceX, o.faceX) && same(faceZ, o.faceZ) && same(fire, o.fire);
+    }
+};
+
+static EnemySteerParams steerParams() {
+    return EnemySteerParams{ 0.0f, -0.45f, 0.0f, 2.0f, 5.0f, 3.0f, 25.0f };
+}
+
+static bool checkEnemySteerOracle() {
+    for (size_t n : { size_t(0), size_t(1), size_t(3), size_t(7), size_t(8), size_t(13), size_t(1000) }) {
+        Rng rng(2024, n);
+        SteerArrays simd(rng, n);
+        SteerArrays scalar = simd;
+        for (int tick = 0; tick < 200; ++tick) {
+            const EnemySteerParams p = steerParams();
+            SteerEnemies(simd.View(), p);
+            SteerEnemiesScalar(scalar.View(), p);
+            if (!simd.BitEqual(scalar)) {
+                std::cout << "enemy steer oracle MISMATCH (" << EnemySteerPath() << "): n=" << n
+                          << " tick " << tick << "\n";
+                return false;
+            }
+        }
+    }
+    std::cout << "enemy steer oracle (" << EnemySteerPath() << " vs scalar): OK\n";
+    return true;
+}
+
+static void benchEnemySteer() {
+    Rng rng(31337, 6);
+    const EnemySteerParams p = steerParams();
+    std::cout << std::fixed << std::setprecision(3)
+              << "      enemies   ticks   " << EnemySteerPath() << "(ns/enemy)   scalar(ns/enemy)\n";
+    for (size_t n : { size_t(200), size_t(2000), size_t(20000), size_t(200000) }) {
+        SteerArrays simd(rng, n);
+        SteerArrays scalar = simd;
+        const int ticks = static_cast<int>(std::max<size_t>(20000000 / n, 10));
+
+        BenchClock::time_point t = BenchClock::now();
+        for (int k = 0; k < ticks; ++k) SteerEnemies(simd.View(), p);
+        const double simdNs = elapsedSeconds(t) * 1e9 / (static_cast<double>(ticks) * n);
+
+        t = BenchClock::now();
+        for (int k = 0; k < ticks; ++k) SteerEnemiesScalar(scalar.View(), p);
+        const double scalarNs = elapsedSeconds(t) * 1e9 / (static_cast<double>(ticks) * n);
+
+        std::cout << std::setw(13) << n << std::setw(8) << ticks
+                  << std::setw(17) << simdNs << std::setw(19) << scalarNs << "\n";
+    }
+}
+
+static bool checkJobSystemOracle() {
+    for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+        JobSystem jobs(threads);
+        for (size_t count : { size_t(0), size_t(1), size_t(255), size_t(256), size_t(257), size_t(10000) }) {
+            for (size_t grain : { size_t(1), size_t(7), size_t(256) }) {
+                std::vector<uint8_t> visits(count, 0);
+                std::vector<uint8_t> badSlot(jobs.ThreadCount() + 1, 0);
+                jobs.ParallelFor(count, grain, [&](size_t begin, size_t end, unsigned slot) {
+                    if (slot >= jobs.ThreadCount() || end - begin > grain) badSlot[jobs.ThreadCount()] = 1;
+                    for (size_t i = begin; i < end; ++i) ++visits[i];
+                });
+                const bool once = std::all_of(visits.begin(), visits.end(), [](uint8_t v) { return v == 1; });
+                if (!once || badSlot[jobs.ThreadCount()]) {
+                    std::cout << "job system oracle MISMATCH: threads=" << threads << " count=" << count
+                              << " grain=" << grain << "\n";
+                    return false;
+                }
+            }
+        }
+    }
+    std::cout << "job system oracle: OK\n";
+    return true;
+}
+
+// The enemy AI step as EnemyManager runs it: the steering kernel over 256-boat chunks.
+static void benchParallelSteer() {
+    const size_t n = 200000;
+    const int ticks = 50;
+    const EnemySteerParams p = steerParams();
+    Rng rng(808, 7);
+    const SteerArrays start(rng, n);
+    SteerArrays reference = start;
+
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << std::fixed << std::setprecision(3)
+              << "enemy AI step, " << n << " boats (" << hw << " hardware threads)\n"
+              << "      threads   ms/tick   speedup\n";
+    double oneThreadMs = 0.0;
+    for (unsigned threads = 1; threads <= std::max(hw, 4u); threads *= 2) {
+        JobSystem jobs(threads);
+        SteerArrays arrays = start;
+        BenchClock::time_point t = BenchClock::now();
+        for (int k = 0; k < ticks; ++k) {
+            jobs.ParallelFor(n, 256, [&](size_t begin, size_t end, unsigned) {
+                const EnemySteerArrays a{ arrays.x.data() + begin, arrays.y.data() + begin, arrays.z.data() + begin,
+                                          arrays.armed.data() + begin, arrays.faceX.data() + begin,
+                                          arrays.faceZ.data() + begin, arrays.dt.data() + begin, arrays.active.data() + begin,
+                                          arrays.fire.data() + begin, end - begin };
+                SteerEnemies(a, p);
+            });
+        }
+        const double ms = elapsedSeconds(t) * 1e3 / ticks;
+        if (threads == 1) {
+            oneThreadMs = ms;
+            reference = arrays;
+        } else if (!arrays.BitEqual(reference)) {
+            std::cout << "  (results differ from 1 thread)\n";
+        }
+        std::cout << std::setw(13) << threads << std::setw(10) << ms << std::setw(10) << oneThreadMs / ms << "\n";
+    }
+}
+
+// Boats for the flocking tests: positions from scatterPoints, random unit headings.
+struct FlockBoats {
+    std::vector<glm::vec3> position;
+    std::vector<float>     headingX, headingZ;
+
+    FlockBoats(Rng& rng, size_t n) : position(scatterPoints(rng, n)), headingX(n), headingZ(n) {
+        for (size_t i = 0; i < n; ++i) {
+            const float a = rng.Range(0.0f, 6.2831853f);
+            headingX[i] = std::cos(a);
+            headingZ[i] = std::sin(a);
+        }
+        if (n > 3) position[3] = position[2]; // two boats on the same spot
+    }
+    FlockView View() const { return FlockView{ position.data(), headingX.data(), headingZ.data() }; }
+    void Build(SpatialHash& grid) const {
+        grid.Begin(position.size());
+        for (size_t i = 0; i < position.size(); ++i) grid.Add(static_cast<uint32_t>(i), position[i]);
+        grid.Finalize();
+    }
+};
+
+static FlockParams flockParams(size_t maxNeighbors) {
+    return FlockParams{ 6.0f, 3.0f, maxNeighbors, 2.0f, 0.3f, 0.3f, 2.0f };
+}
+
+// With the neighbor cap out of the way the grid must find the same neighbors as the
+// full scan; only the summation order differs.
+static bool checkFlockingOracle() {
+    const FlockParams p = flockParams(100000);
+    for (size_t n : { size_t(1), size_t(2), size_t(50), size_t(1500) }) {
+        Rng rng(99, n);
+        const FlockBoats boats(rng, n);
+        SpatialHash grid(p.radius);
+        boats.Build(grid);
+        for (uint32_t i = 0; i < n; ++i) {
+            const glm::vec2 a = FlockSteer(grid, boats.View(), i, p);
+            const glm::vec2 b = FlockSteerBruteForce(boats.View(), n, i, p);
+            if (std::fabs(a.x - b.x) > 1e-4f || std::fabs(a.y - b.y) > 1e-4f) {
+                std::cout << "flocking oracle MISMATCH: n=" << n << " boat " << i << "\n";
+                return false;
+            }
+        }
+    }
+    std::cout << "flocking oracle: OK\n";
+    return true;
+}
+
+// Grid rebuild plus one steering query per boat, as EnemyManager does each tick. The cost
+// per boat should stay flat as the fleet grows; the full scan is shown for comparison.
+static void benchFlocking() {
+    const FlockParams p = flockParams(8);
+    std::cout << std::fixed << std::setprecision(1)
+              << "        boats   grid(ns/boat)   brute(ns/boat)\n";
+    for (size_t n : { size_t(100), size_t(1000), size_t(10000), size_t(50000) }) {
+        Rng rng(5150, n);
+        const FlockBoats boats(rng, n);
+        SpatialHash grid(p.radius);
+        const int reps = static_cast<int>(std::max<size_t>(2000000 / n, 3));
+
+        float sink = 0.0f;
+        BenchClock::time_point t = BenchClock::now();
+        for (int r = 0; r < reps; ++r) {
+            boats.Build(grid);
+            for (uint32_t i = 0; i < n; ++i) sink += FlockSteer(grid, boats.View(), i, p).x;
+        }
+        const double gridNs = elapsedSeconds(t) * 1e9 / (static_cast<double>(reps) * n);
+
+        std::cout << std::setw(13) << n << std::setw(16) << gridNs;
+        if (n <= 10000) {
+            t = BenchClock::now();
+            for (uint32_t i = 0; i < n; ++i) sink += FlockSteerBruteForce(boats.View(), n, i, p).x;
+            std::cout << std::setw(17) << elapsedSeconds(t) * 1e9 / static_cast<double>(n);
+        } else {
+            std::cout << std::setw(17) << "-";
+        }
+        std::cout << (sink == 12345.0f ? " " : "") << "\n";
+    }
+}
+
+// Mountains around the origin at the game's sizes, a few more than a match keeps alive.
+static std::vector<Mountain> navMountains(Rng& rng, size_t n) {
+    std::vector<Mountain> list(n);
+    for (auto& m : list) {
+        const float s = rng.Range(10.0f, 20.0f);
+        m.position = glm::vec3(rng.Range(-160.0f, 160.0f), -1.0f, rng.Range(-160.0f, 160.0f));
+        m.scale = glm::vec3(s);
+        m.radius = 3.0f * s;
+        m.textureIndex = 0;
+        m.active = true;
+    }
+    return list;
+}
+
+// The discrete eikonal equations NavField solves, relaxed over every cell until nothing
+// changes, as a check on the fast-marching order.
+static std::vector<float> sweepNavDistances(const NavField& field) {
+    const int n = field.CellsPerSide();
+    const float h = field.GetCellSize();
+    const float inf = NavField::kUnreachable;
+    std::vector<float> d(static_cast<size_t>(n) * n, inf);
+    auto at = [&](int x, int z) { return (x < 0 || z < 0 || x >= n || z >= n) ? inf : d[static_cast<size_t>(z) * n + x]; };
+    d[static_cast<size_t>(n / 2) * n + n / 2] = 0.0f;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int z = 0; z < n; ++z) {
+            for (int x = 0; x < n; ++x) {
+                if ((x == n / 2 && z == n / 2) || field.BlockedAt(x, z)) continue;
+                float a = std::min(at(x - 1, z), at(x + 1, z));
+                float b = std::min(at(x, z - 1), at(x, z + 1));
+                if (a > b) std::swap(a, b);
+                if (a == inf) continue;
+                const float t = (b - a >= h) ? a + h : 0.5f * (a + b + std::sqrt(2.0f * h * h - (b - a) * (b - a)));
+                float& cell = d[static_cast<size_t>(z) * n + x];
+                if (t < cell - 1e-4f) changed = true;
+                if (t < cell) cell = t;
+            }
+        }
+    }
+    return d;
+}
+
+// The player wanders, now and then jumps far away, and mountains move under it. After
+// each step the incrementally refreshed field must match one built from scratch, its
+// blocked cells must match the mountains, and its distances the relaxed equations.
+static bool checkNavFieldOracle() {
+    Rng rng(1812, 8);
+    MountainManager mountains;
+    std::vector<Mountain> list = navMountains(rng, 10);
+    mountains.SetMountains(list);
+    NavField field(64, 4.0f, 1.0f);
+    field.Init();
+    glm::vec3 player(0.0f, -0.45f, 0.0f);
+
+    for (int step = 0; step < 300; ++step) {
+        const float roll = rng.NextFloat01();
+        if (roll < 0.03f) {
+            player += glm::vec3(rng.Range(-600.0f, 600.0f), 0.0f, rng.Range(-600.0f, 600.0f));
+        } else {
+            player += glm::vec3(rng.Range(-7.0f, 7.0f), 0.0f, rng.Range(-7.0f, 7.0f));
+        }
+        if (roll > 0.8f) {
+            Mountain& m = list[static_cast<size_t>(rng.RangeInt(0, static_cast<int>(list.size())))];
+            m.position = player + glm::vec3(rng.Range(-150.0f, 150.0f), 0.0f, rng.Range(-150.0f, 150.0f));
+            m.radius = rng.Range(30.0f, 60.0f);
+            m.active = rng.NextFloat01() < 0.9f;
+            mountains.SetMountains(list);
+        }
+        field.Refresh(player, mountains);
+
+        NavField fresh(64, 4.0f, 1.0f);
+        fresh.Init();
+        fresh.Refresh(player, mountains);
+        const int n = field.CellsPerSide();
+        const float margin = field.GetClearance() + field.GetCellSize() * 0.70710678f;
+        for (int z = 0; z < n; ++z) {
+            for (int x = 0; x < n; ++x) {
+                const glm::vec3 c = field.CellCenter(x, z);
+                bool want = false;
+                for (const Mountain& m : list) {
+                    const float dx = c.x - m.position.x, dz = c.z - m.position.z, reach = m.radius + margin;
+                    want |= m.active && dx * dx + dz * dz < reach * reach;
+                }
+                if (field.BlockedAt(x, z) != want || fresh.BlockedAt(x, z) != want ||
+                    field.DistanceAt(x, z) != fresh.DistanceAt(x, z)) {
+                    std::cout << "nav field oracle MISMATCH: step " << step << " cell " << x << "," << z << "\n";
+                    return false;
+                }
+            }
+        }
+        if (step % 25 != 0) continue;
+        const std::vector<float> want = sweepNavDistances(fresh);
+        for (int z = 0; z < n; ++z) {
+            for (int x = 0; x < n; ++x) {
+                const float got = fresh.DistanceAt(x, z), w = want[static_cast<size_t>(z) * n + x];
+                const bool ok = (got == NavField::kUnreachable || w == NavField::kUnreachable)
+                                    ? got == w : std::fabs(got - w) <= 1e-3f * std::max(1.0f, w);
+                if (!ok) {
+                    std::cout << "nav field oracle MISMATCH: step " << step << " cell " << x << "," << z
+                              << " distance " << got << " want " << w << "\n";
+                    return false;
+                }
+            }
+        }
+    }
+    std::cout << "nav field oracle: OK\n";
+    return true;
+}
+
+// One solve per refresh, then one sample per boat: the solve cost is fixed and the
+// per-boat cost stays flat however many boats share the field.
+static void benchNavField() {
+    Rng rng(4096, 9);
+    MountainManager mountains;
+    mountains.SetMountains(navMountains(rng, 6));
+    NavField field(64, 4.0f, 1.0f);
+
+    const int reps = 200;
+    BenchClock::time_point t = BenchClock::now();
+    for (int r = 0; r < reps; ++r) {
+        field.Init();
+        field.Refresh(glm::vec3(0.0f), mountains);
+    }
+    const double fullMs = elapsedSeconds(t) * 1e3 / reps;
+
+    glm::vec3 player(0.0f);
+    t = BenchClock::now();
+    for (int r = 0; r < reps; ++r) {
+        player.x += field.GetCellSize(); // one cell per refresh
+        field.Refresh(player, mountains);
+    }
+    const double scrollMs = elapsedSeconds(t) * 1e3 / reps;
+
+    std::cout << std::fixed << std::setprecision(3)
+              << field.CellsPerSide() << "x" << field.CellsPerSide() << " cells: full rebuild " << fullMs
+              << " ms, scroll one cell " << scrollMs << " ms\n"
+              << "        boats   sample(ns/boat)\n";
+    for (size_t n : { size_t(100), size_t(1000), size_t(10000), size_t(100000) }) {
+        std::vector<glm::vec3> boats(n);
+        for (auto& b : boats) b = player + glm::vec3(rng.Range(-120.0f, 120.0f), 0.0f, rng.Range(-120.0f, 120.0f));
+        const int passes = static_cast<int>(std::max<size_t>(4000000 / n, 3));
+        glm::vec2 dir, sum(0.0f);
+        t = BenchClock::now();
+        for (int r = 0; r < passes; ++r)
+            for (const auto& b : boats) if (field.Sample(b, dir)) sum += dir;
+        const double ns = elapsedSeconds(t) * 1e9 / (static_cast<double>(passes) * n);
+        std::cout << std::setw(13) << n << std::setw(18) << ns << (sum.x == 12345.0f ? " " : "") << "\n";
+    }
+}
+
+static uint32_t mixBits(uint32_t a, uint32_t b) {
+    uint32_t h = a * 0x9E3779B1u ^ (b + 0x7F4A7C15u) * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0xC2B2AE3Du;
+    return h ^ (h >> 13);
+}
+
+// How oracle task `key` waits after its n-th resume: a signal, or a sleep of 1..97 ticks.
+static bool oracleWaitsForSignal(uint32_t key, uint32_t n) { return mixBits(key, n) % 4 == 0; }
+static uint32_t oracleSleepTicks(uint32_t key, uint32_t n) { return 1 + mixBits(key, n) % 97; }
+static uint32_t oracleResumes(uint32_t key) { return 5 + key % 40; }
+
+using ResumeLog = std::vector<std::pair<uint32_t, uint32_t>>; // (tick, key)
+
+static BehaviorTask oracleTask(BehaviorScheduler& s, uint32_t key, ResumeLog& log) {
+    for (uint32_t n = 0; n < oracleResumes(key); ++n) {
+        log.emplace_back(s.Now(), key);
+        if (oracleWaitsForSignal(key, n)) co_await s.WaitSignal();
+        else                              co_await s.Sleep(oracleSleepTicks(key, n));
+    }
+}
+
+// Tasks with scripted waits are started, signalled and stopped at random. The order they
+// resume in must match a plain list that walks every task on every tick.
+static bool checkBehaviorOracle() {
+    struct Model {
+        uint32_t key, id, resumes = 0, due = 0;
+        uint64_t order = 0;
+        bool     alive = true, waiting = false;
+    };
+    Rng rng(1999, 10);
+    BehaviorScheduler scheduler;
+    ResumeLog got, want;
+    std::vector<Model> model;
+    uint64_t order = 0;
+    uint32_t nextKey = 0;
+
+    // What the scheduler does when it resumes m at tick.
+    auto resume = [&](Model& m, uint32_t tick) {
+        if (m.resumes == oracleResumes(m.key)) { m.alive = false; return; }
+        want.emplace_back(tick, m.key);
+        m.waiting = oracleWaitsForSignal(m.key, m.resumes);
+        if (!m.waiting) {
+            m.due = tick + oracleSleepTicks(m.key, m.resumes);
+            m.order = order++;
+        }
+        ++m.resumes;
+    };
+
+    for (uint32_t tick = 1; tick <= 3000; ++tick) {
+        scheduler.RunUntil(tick);
+        std::vector<Model*> due;
+        for (Model& m : model) if (m.alive && !m.waiting && m.due <= tick) due.push_back(&m);
+        std::sort(due.begin(), due.end(), [](const Model* a, const Model* b) {
+            return a->due != b->due ? a->due < b->due : a->order < b->order;
+        });
+        for (Model* m : due) resume(*m, tick);
+
+        const int starts = rng.RangeInt(0, 4);
+        for (int k = 0; k < starts; ++k) {
+            const uint32_t key = nextKey++;
+            const uint32_t id = scheduler.Start(oracleTask(scheduler, key, got));
+            model.push_back(Model{ key, id, 0, tick, order++ });
+        }
+        for (int k = 0; k < 6 && !model.empty(); ++k) {
+            Model& m = model[static_cast<size_t>(rng.RangeInt(0, static_cast<int>(model.size())))];
+            if (!m.alive) continue;
+            if (rng.NextFloat01() < 0.1f) {
+                scheduler.Stop(m.id);
+                m.alive = false;
+            } else {
+                scheduler.Signal(m.id);
+                if (m.waiting) resume(m, tick);
+            }
+        }
+
+        size_t live = 0, waiting = 0;
+        for (const Model& m : model) {
+            live += m.alive;
+            waiting += m.alive && m.waiting;
+        }
+        if (got != want || scheduler.Live() != live || scheduler.WaitingForSignal() != waiting) {
+            std::cout << "behavior oracle MISMATCH: tick " << tick << " (" << got.size() << " resumes, want "
+                      << want.size() << "; " << scheduler.Live() << " live, want " << live << ")\n";
+            return false;
+        }
+    }
+    std::cout << "behavior oracle: OK (" << got.size() << " resumes)\n";
+    return true;
+}
+
+// A gunner loop: wait to fire, then reload for two seconds.
+static BehaviorTask benchGunner(BehaviorScheduler& s) {
+    for (;;) {
+        co_await s.WaitSignal();
+        co_await s.Sleep(120);
+    }
+}
+
+// Per-tick cost of N gunners as behaviors against the polling loop they replace, which
+// counts every boat's cooldown down each tick. Idle: nobody is in range to fire. Busy:
+// every gunner fires as soon as it has reloaded.
+static void benchBehaviors() {
+    std::cout << std::fixed << std::setprecision(3)
+              << "     gunners   idle: tasks(us/tick)  polling(us/tick)   busy: tasks(us/tick)  polling(us/tick)\n";
+    for (size_t n : { size_t(1000), size_t(10000), size_t(100000) }) {
+        const uint32_t ticks = 600;
+        double result[2][2];
+        for (int busy = 0; busy < 2; ++busy) {
+            BehaviorScheduler scheduler;
+            std::vector<uint32_t> ids(n);
+            for (size_t i = 0; i < n; ++i) ids[i] = scheduler.Start(benchGunner(scheduler));
+            scheduler.RunUntil(1);
+
+            BenchClock::time_point t = BenchClock::now();
+            for (uint32_t tick = 2; tick < 2 + ticks; ++tick) {
+                scheduler.RunUntil(tick);
+                if (busy) for (size_t i = tick % 120; i < n; i += 120) scheduler.Signal(ids[i]);
+            }
+            result[busy][0] = elapsedSeconds(t) * 1e6 / ticks;
+
+            std::vector<float> cooldown(n, 0.0f);
+            size_t shots = 0;
+            t = BenchClock::now();
+            for (uint32_t tick = 2; tick < 2 + ticks; ++tick) {
+                for (size_t i = 0; i < n; ++i) {
+                    if (cooldown[i] > 0.0f) cooldown[i] -= 1.0f / 60.0f;
+                    else if (busy) { cooldown[i] = 2.0f; ++shots; }
+                }
+            }
+            result[busy][1] = elapsedSeconds(t) * 1e6 / ticks;
+            if (shots == 1) std::cout << " ";
+        }
+        std::cout << std::setw(12) << n << std::setw(23) << result[0][0] << std::setw(18) << result[0][1]
+                  << std::setw(23) << result[1][0] << std::setw(18) << result[1][1] << "\n";
+    }
+}
+
+// What oracle timer `tag` does when it fires at tick: maybe schedule another timer a few
+// ticks out (possibly on this very tick), maybe cancel the timer scheduled just before it.
+static uint32_t oracleFollowUp(uint64_t tag) { return mixBits(static_cast<uint32_t>(tag), 7); }
+
+// One oracle phase: timers are scheduled, cancelled and fired at random. Deadlines go up to
+// maxAhead ticks out (a few slightly in the past), and each Advance jumps up to maxStep
+// ticks. The firing order must match a plain list that is scanned tick by tick for the
+// earliest (deadline, order scheduled), deadlines in the past counting as the current tick.
+static bool checkTimerWheelPhase(uint64_t seed, uint32_t start, uint32_t maxAhead, uint32_t maxStep, int steps,
+                                 size_t& firedTotal) {
+    struct Model {
+        uint32_t due;
+        uint64_t order;
+        bool     alive;
+    };
+    using FireLog = std::vector<std::pair<uint32_t, uint64_t>>; // (tick, tag)
+    Rng rng(seed, 11);
+
+    TimerWheel wheel;
+    wheel.Reset(start);
+    std::vector<TimerHandle> handles; // by tag
+    FireLog got;
+
+    std::vector<Model> model;         // by tag
+    uint64_t order = 0;
+    FireLog want;
+
+    auto addWheel = [&](uint32_t due) { handles.push_back(wheel.Schedule(due, handles.size())); };
+    auto addModel = [&](uint32_t due, uint32_t tick) { model.push_back(Model{ std::max(due, tick), order++, true }); };
+
+    uint32_t now = start;
+    for (int step = 0; step < steps; ++step) {
+        const int adds = rng.RangeInt(0, 6);
+        for (int k = 0; k < adds; ++k) {
+            const uint32_t due = now + rng.NextU32() % (maxAhead + 1) - (rng.NextFloat01() < 0.05f ? 3u : 0u);
+            addWheel(due);
+            addModel(due, now);
+        }
+        for (int k = 0; k < 2 && !model.empty(); ++k) {
+            const size_t tag = rng.NextU32() % model.size();
+            if (wheel.Cancel(handles[tag]) != model[tag].alive) {
+                std::cout << "timer wheel oracle MISMATCH: cancel of " << tag << " at tick " << now << "\n";
+                return false;
+            }
+            model[tag].alive = false;
+        }
+
+        const uint32_t target = now + 1 + rng.NextU32() % maxStep;
+        wheel.Advance(target, [&](uint64_t tag) {
+            const uint32_t tick = wheel.Now();
+            got.emplace_back(tick, tag);
+            const uint32_t h = oracleFollowUp(tag);
+            if (h % 3 == 0) addWheel(tick + h % 5);
+            if (h % 7 == 0 && tag > 0) wheel.Cancel(handles[tag - 1]);
+        });
+
+        for (uint32_t tick = now; tick <= target; ++tick) {
+            for (;;) {
+                size_t best = model.size();
+                for (size_t k = 0; k < model.size(); ++k) {
+                    const Model& m = model[k];
+                    if (!m.alive || m.due > tick) continue;
+                    if (best == model.size() || m.due < model[best].due ||
+                        (m.due == model[best].due && m.order < model[best].order))
+                        best = k;
+                }
+                if (best == model.size()) break;
+                model[best].alive = false;
+                want.emplace_back(tick, best);
+                const uint32_t h = oracleFollowUp(best);
+                if (h % 3 == 0) addModel(tick + h % 5, tick);
+                if (h % 7 == 0 && best > 0) model[best - 1].alive = false;
+            }
+        }
+        now = target;
+
+        size_t live = 0;
+        for (const Model& m : model) live += m.alive;
+        if (got != want || wheel.Size() != live || wheel.Now() != now) {
+            std::cout << "timer wheel oracle MISMATCH: tick " << now << " (" << got.size() << " fired, want "
+                      << want.size() << "; " << wheel.Size() << " pending, want " << live << ")\n";
+            return false;
+        }
+    }
+    firedTotal += got.size();
+    return true;
+}
+
+// Dense near deadlines with single-tick steps, then sparse ones spread over several turns
+// of every level, including past the top one.
+static bool checkTimerWheelOracle() {
+    size_t fired = 0;
+    if (!checkTimerWheelPhase(2024, 100, 300, 1, 4000, fired)) return false;
+    if (!checkTimerWheelPhase(2025, 4000, 5000, 64, 2000, fired)) return false;
+    if (!checkTimerWheelPhase(2026, (1u << 24) - 5000, 1u << 20, 1u << 16, 300, fired)) return false;
+    std::cout << "timer wheel oracle: OK (" << fired << " timers fired)\n";
+    return true;
+}
+
+// Per-tick cost of N countdowns kept in a wheel against the loop they replace, which
+// decrements every one of them each tick. Each timer restarts with a new 0.1-10 s deadline
+// when it runs out, so roughly N/300 expire per tick at 60 Hz.
+static void benchTimerWheel() {
+    std::cout << std::fixed << std::setprecision(3)
+              << "      timers   wheel(us/tick)  decrement(us/tick)  fired/tick\n";
+    for (size_t n : { size_t(1000), size_t(10000), size_t(100000), size_t(1000000) }) {
+        const uint32_t ticks = 600;
+        Rng rng(7, 12);
+        std::vector<uint32_t> period(n);
+        for (auto& p : period) p = 6 + rng.NextU32() % 595;
+
+        TimerWheel wheel;
+        for (size_t i = 0; i < n; ++i) wheel.Schedule(period[i], i);
+        size_t fired = 0;
+        BenchClock::time_point t = BenchClock::now();
+        for (uint32_t tick = 1; tick <= ticks; ++tick) {
+            wheel.Advance(tick, [&](uint64_t i) {
+                wheel.Schedule(tick + period[i], i);
+                ++fired;
+            });
+        }
+        const double wheelUs = elapsedSeconds(t) * 1e6 / ticks;
+
+        std::vector<float> remaining(n);
+        for (size_t i = 0; i < n; ++i) remaining[i] = period[i] / 60.0f;
+        size_t expired = 0;
+        t = BenchClock::now();
+        for (uint32_t tick = 1; tick <= ticks; ++tick) {
+            for (size_t i = 0; i < n; ++i) {
+                remaining[i] -= 1.0f / 60.0f;
+                if (remaining[i] <= 0.0f) {
+                    remaining[i] += period[i] / 60.0f;
+                    ++expired;
+                }
+            }
+        }
+        const double decrementUs = elapsedSeconds(t) * 1e6 / ticks;
+        std::cout << std::setw(12) << n << std::setw(17) << wheelUs << std::setw(20) << decrementUs
+                  << std::setw(12) << static_cast<double>(fired) / ticks << (expired == 1 ? " " : "") << "\n";
+    }
+}
+
+// Earliest time a shell at speed s from `from` can meet a target starting at `target` with
+// XZ velocity vel: the first t where |target + vel t - from + g t^2/2 up| <= s t, found by
+// scanning in 1 ms steps and bisecting. minGap is how close the scan came when it never got there.
+static bool bruteIntercept(const glm::vec3& from, const glm::vec3& target, const glm::vec3& vel, float s,
+                           float& when, float& minGap) {
+    auto gap = [&](float t) {
+        glm::vec3 d = target + glm::vec3(vel.x * t, 0.0f, vel.z * t) - from;
+        d.y += 0.5f * kGravity * t * t;
+        return glm::length(d) - s * t;
+    };
+    minGap = 1e9f;
+    float prev = 0.0f;
+    for (int k = 1; k <= 10000; ++k) {
+        const float t = k * 1e-3f;
+        const float g = gap(t);
+        minGap = std::min(minGap, g);
+        if (g <= 0.0f) {
+            float lo = prev, hi = t;
+            for (int b = 0; b < 40; ++b) {
+                const float mid = 0.5f * (lo + hi);
+                (gap(mid) <= 0.0f ? hi : lo) = mid;
+            }
+            when = hi;
+            return true;
+        }
+        prev = t;
+    }
+    return false;
+}
+
+// Shooters around a target moving at up to targetSpeed: whether it is in reach and the
+// flight time must match the brute-force search, and an in-range shell must actually meet
+// the target. Cases that miss reach by a whisker either way are skipped.
+static bool checkInterceptOracle() {
+    const float shellSpeed = 18.0f;
+    size_t inRange = 0, outOfRange = 0, skipped = 0;
+    for (float targetSpeed : { 0.0f, 8.0f, 16.0f, 28.0f }) {
+        Rng rng(606, static_cast<uint64_t>(targetSpeed));
+        const size_t n = 500;
+        std::vector<float> fromX(n), fromY(n), fromZ(n), velX(n), velY(n), velZ(n), flight(n);
+        std::vector<uint8_t> reach(n);
+        const glm::vec3 target(rng.Range(-50.0f, 50.0f), -0.5f, rng.Range(-50.0f, 50.0f));
+        const float heading = rng.Range(0.0f, 6.2831853f);
+        const glm::vec3 vel(std::cos(heading) * targetSpeed, 0.0f, std::sin(heading) * targetSpeed);
+        for (size_t i = 0; i < n; ++i) {
+            const float a = rng.Range(0.0f, 6.2831853f), d = rng.Range(5.0f, 40.0f);
+            fromX[i] = target.x + std::cos(a) * d;
+            fromY[i] = rng.Range(-0.6f, 0.5f);
+            fromZ[i] = target.z + std::sin(a) * d;
+        }
+        const InterceptArrays arrays{ fromX.data(), fromY.data(), fromZ.data(), velX.data(), velY.data(), velZ.data(),
+                                      flight.data(), reach.data(), n };
+        SolveIntercepts(arrays, InterceptParams{ target.x, target.y, target.z, vel.x, vel.z, shellSpeed });
+
+        for (size_t i = 0; i < n; ++i) {
+            const glm::vec3 from(fromX[i], fromY[i], fromZ[i]);
+            float when = 0.0f, minGap = 0.0f;
+            const bool want = bruteIntercept(from, target, vel, shellSpeed, when, minGap);
+            if (!want && minGap < 0.05f) { ++skipped; continue; }
+            const glm::vec3 launch(velX[i], velY[i], velZ[i]);
+            const glm::vec3 miss = BallisticPosition(from, launch, flight[i]) - (target + vel * flight[i]);
+            const bool bad = (reach[i] != 0) != want ||
+                             (want && (std::fabs(flight[i] - when) > 1e-3f || glm::length(miss) > 0.01f ||
+                                       std::fabs(glm::length(launch) - shellSpeed) > 0.05f));
+            if (bad) {
+                std::cout << "intercept oracle MISMATCH: target speed " << targetSpeed << " shooter " << i
+                          << " in range " << int(reach[i]) << " want " << want << ", flight " << flight[i]
+                          << " want " << when << ", miss " << glm::length(miss) << "\n";
+                return false;
+            }
+            (want ? inRange : outOfRange) += 1;
+        }
+    }
+    std::cout << "intercept oracle: OK (" << inRange << " in range, " << outOfRange << " out of range, "
+              << skipped << " on the edge skipped)\n";
+    return true;
+}
+
+// Shells fired from a ring at a target weaving around the middle. Every tick the lazy check
+// must find exactly the shells whose last tick of flight a test of all of them finds.
+static bool checkLazyHitOracle() {
+    Rng rng(1707, 2);
+    MountainManager mountains;
+    mountains.SetMountains({});
+    ProjectileManager projectiles;
+    projectiles.Init(4096);
+    const float dt = 1.0f / 60.0f, radius = 1.5f, topSpeed = 16.0f;
+    glm::vec3 target(0.0f, -1.0f, 0.0f);
+    float heading = 0.0f;
+    std::vector<uint32_t> got, want;
+    size_t hits = 0;
+    for (int tick = 0; tick < 3000; ++tick) {
+        heading += rng.Range(-0.2f, 0.2f);
+        target += glm::vec3(std::cos(heading), 0.0f, std::sin(heading)) * (rng.Range(0.0f, topSpeed) * dt);
+        for (int k = 0; k < 3; ++k) {
+            const float a = rng.Range(0.0f, 6.2831853f), d = rng.Range(5.0f, 35.0f);
+            const glm::vec3 from = target + glm::vec3(std::cos(a) * d, 0.55f, std::sin(a) * d);
+            const glm::vec3 aim = target - from;
+            const glm::vec3 vel = glm::normalize(glm::vec3(aim.x, 0.0f, aim.z)) * rng.Range(8.0f, 16.0f) +
+                                  glm::vec3(0.0f, rng.Range(0.0f, 8.0f), 0.0f);
+            projectiles.AddBallistic(from, vel, false);
+        }
+        projectiles.Schedule(dt, mountains);
+        projectiles.Integrate(dt);
+
+        want.clear();
+        const ProjectileStore& store = projectiles.GetProjectiles();
+        for (size_t i = 0; i < store.Size(); ++i) {
+            if (SegmentDistance2(projectiles.PreviousPosition(i), projectiles.Position(i), target) < radius * radius)
+                want.push_back(static_cast<uint32_t>(i));
+        }
+        projectiles.CollectHitsOnTarget(target, radius, topSpeed, got);
+        if (got != want) {
+            std::cout << "lazy hit oracle MISMATCH: tick " << tick << " found " << got.size() << " want " << want.size() << "\n";
+            return false;
+        }
+        hits += got.size();
+        for (size_t k = got.size(); k-- > 0;) projectiles.Remove(got[k]);
+    }
+    std::cout << "lazy hit oracle: OK (" << hits << " hits)\n";
+    return true;
+}
+
+// Per-tick cost of N enemy shells in flight: advancing the clock and checking the shells
+// whose check is due, against stepping every position and testing every shell. Both leave a
+// smoke puff every 6 ticks, and shells that splash down are replaced, so the count stays at N.
+static void benchBallistics() {
+    std::cout << std::fixed << std::setprecision(3)
+              << "       shells   lazy(us/tick)   stepped(us/tick)   timers/tick\n";
+    MountainManager mountains;
+    mountains.SetMountains({});
+    const float dt = 1.0f / 60.0f, radius = 1.5f, topSpeed = 28.0f;
+    for (size_t n : { size_t(100), size_t(1000), size_t(10000), size_t(100000) }) {
+        const int ticks = 600;
+        Rng rng(99, n);
+        auto launch = [&](glm::vec3& from, glm::vec3& vel) {
+            const float a = rng.Range(0.0f, 6.2831853f), d = rng.Range(5.0f, 200.0f), b = rng.Range(0.0f, 6.2831853f);
+            from = glm::vec3(std::cos(a) * d, -0.45f, std::sin(a) * d);
+            vel = glm::vec3(std::cos(b) * 15.0f, rng.Range(2.0f, 12.0f), std::sin(b) * 15.0f);
+        };
+
+        ProjectileManager lazy;
+        lazy.Init(n);
+        std::vector<uint32_t> hits;
+        glm::vec3 from, vel;
+        const uint64_t firedBefore = lazy.GetTimers().GetStats().fired;
+        BenchClock::time_point t = BenchClock::now();
+        for (int tick = 0; tick < ticks; ++tick) {
+            for (size_t k = lazy.GetProjectiles().Size(); k < n; ++k) {
+                launch(from, vel);
+                lazy.AddBallistic(from, vel, false);
+            }
+            lazy.Schedule(dt, mountains);
+            lazy.Integrate(dt);
+            lazy.CollectHitsOnTarget(glm::vec3(0.0f, -1.0f, 0.0f), radius, topSpeed, hits);
+            for (size_t k = hits.size(); k-- > 0;) lazy.Remove(hits[k]);
+        }
+        const double lazyUs = elapsedSeconds(t) * 1e6 / ticks;
+        const double timersPerTick = static_cast<double>(lazy.GetTimers().GetStats().fired - firedBefore) / ticks;
+
+        // The loop it replaces: positions stepped every tick, every shell tested.
+        std::vector<glm::vec3> pos(n), v(n);
+        std::vector<SmokeRing> smoke(n);
+        for (size_t i = 0; i < n; ++i) launch(pos[i], v[i]);
+        size_t stepHits = 0;
+        t = BenchClock::now();
+        for (int tick = 0; tick < ticks; ++tick) {
+            for (size_t i = 0; i < n; ++i) {
+                v[i].y -= kGravity * dt;
+                pos[i] += v[i] * dt;
+                if ((tick + i) % 6 == 0) smoke[i].Push(pos[i]);
+                if (pos[i].y < kSeaLevel) {
+                    launch(pos[i], v[i]);
+                    smoke[i] = SmokeRing();
+                }
+                const glm::vec3 d = pos[i] - glm::vec3(0.0f, -1.0f, 0.0f);
+                if (glm::dot(d, d) < radius * radius) ++stepHits;
+            }
+        }
+        const double steppedUs = elapsedSeconds(t) * 1e6 / ticks;
+        std::cout << std::setw(13) << n << std::setw(16) << lazyUs << std::setw(19) << steppedUs
+                  << std::setw(14) << timersPerTick << (stepHits == 1 ? " " : "") << "\n";
+    }
+}
+
+// A closed, lumpy hull about a boat's proportions: a stretched sphere of rings x segments
+// quads with its radius jittered, so the BVH gets uneven triangles to split.
+static void makeHull(Rng& rng, int rings, int segments, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices) {
+    positions.clear();
+    indices.clear();
+    for (int r = 0; r <= rings; ++r) {
+        const float polar = 3.14159265f * r / rings;
+        for (int k = 0; k < segments; ++k) {
+            const float azimuth = 6.2831853f * k / segments;
+            const float bump = rng.Range(0.9f, 1.1f);
+            positions.emplace_back(0.5f * std::sin(polar) * std::cos(azimuth) * bump, 0.15f * std::cos(polar) * bump,
+                                   0.12f * std::sin(polar) * std::sin(azimuth) * bump);
+        }
+    }
+    for (int r = 0; r < rings; ++r) {
+        for (int k = 0; k < segments; ++k) {
+            const uint32_t a = r * segments + k, b = r * segments + (k + 1) % segments;
+            const uint32_t c = a + segments, d = b + segments;
+            indices.insert(indices.end(), { a, c, b, b, c, d });
+        }
+    }
+}
+
+static bool bruteSegmentHits(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices,
+                             const glm::vec3& a, const glm::vec3& b) {
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const glm::vec3& p0 = positions[indices[t]];
+        if (MeshBvh::SegmentHitsTriangle(a, b - a, p0, positions[indices[t + 1]] - p0, positions[indices[t + 2]] - p0))
+            return true;
+    }
+    return false;
+}
+
+// One tick of shell flight near the hull: a short segment starting somewhere in a box a bit
+// bigger than it, so most graze the bounds and some cross the surface.
+static void nearHullSegment(Rng& rng, float length, glm::vec3& a, glm::vec3& b) {
+    a = glm::vec3(rng.Range(-0.6f, 0.6f), rng.Range(-0.2f, 0.2f), rng.Range(-0.2f, 0.2f));
+    const glm::vec3 dir(rng.Range(-1.0f, 1.0f), rng.Range(-1.0f, 1.0f), rng.Range(-1.0f, 1.0f));
+    b = a + dir * length;
+}
+
+// The BVH must find exactly the segments a test of every triangle finds, for short and
+// long segments, ones along an axis (zero direction components) and zero-length ones.
+static bool checkHullOracle() {
+    Rng rng(2024, 24);
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    size_t tested = 0, hits = 0;
+    for (int rings : { 2, 8, 40 }) {
+        makeHull(rng, rings, rings * 2 + 3, positions, indices);
+        MeshBvh bvh;
+        bvh.Build(positions, indices);
+        for (int k = 0; k < 20000; ++k) {
+            glm::vec3 a, b;
+            nearHullSegment(rng, (k % 4 == 0) ? 1.5f : 0.08f, a, b);
+            if (k % 7 == 0) b = glm::vec3(a.x, a.y, b.z);
+            if (k % 11 == 0) b = a;
+            const bool want = bruteSegmentHits(positions, indices, a, b);
+            if (bvh.SegmentHits(a, b) != want) {
+                std::cout << "hull oracle MISMATCH: " << indices.size() / 3 << " triangles, segment " << k
+                          << " want " << want << "\n";
+                return false;
+            }
+            ++tested;
+            hits += want ? 1 : 0;
+        }
+    }
+    std::cout << "hull oracle: OK (" << tested << " segments, " << hits << " hits)\n";
+    return true;
+}
+
+// A tick's worth of shells near one boat (each a segment of one tick's flight in model
+// space) against hulls of growing size: the BVH against testing every triangle.
+static void benchHulls() {
+    std::cout << std::fixed << std::setprecision(3)
+              << "    triangles   nodes   bvh(us/tick)   brute(us/tick)   hits\n";
+    const size_t shells = 500;
+    for (int rings : { 16, 50, 160, 500 }) {
+        Rng rng(77, static_cast<uint64_t>(rings));
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        makeHull(rng, rings, rings * 2, positions, indices);
+        MeshBvh bvh;
+        bvh.Build(positions, indices);
+        std::vector<glm::vec3> from(shells), to(shells);
+        for (size_t i = 0; i < shells; ++i) nearHullSegment(rng, 0.06f, from[i], to[i]);
+
+        const int ticks = 200;
+        size_t hits = 0;
+        BenchClock::time_point t = BenchClock::now();
+        for (int tick = 0; tick < ticks; ++tick)
+            for (size_t i = 0; i < shells; ++i) hits += bvh.SegmentHits(from[i], to[i]) ? 1 : 0;
+        const double bvhUs = elapsedSeconds(t) * 1e6 / ticks;
+
+        // Brute force is timed on a tenth of the shells once and scaled up; it's that slow.
+        size_t bruteHits = 0;
+        t = BenchClock::now();
+        for (size_t i = 0; i < shells; i += 10) bruteHits += bruteSegmentHits(positions, indices, from[i], to[i]) ? 1 : 0;
+        const double bruteUs = elapsedSeconds(t) * 1e6 * 10.0;
+        std::cout << std::setw(13) << indices.size() / 3 << std::setw(8) << bvh.NodeCount() << std::setw(15) << bvhUs
+                  << std::setw(17) << bruteUs << std::setw(7) << hits / ticks << (bruteHits == 0 ? " " : "") << "\n";
+    }
+}
+
+// The sea with std::sin in double, from the same float inputs.
+static double referenceWaveHeight(float x, float z, float time, double& slack) {
+    const double t = static_cast<double>(time) * kWaveSpeed;
+    double h = 0.0;
+    slack = 0.0;
+    for (const WaveTerm& w : kWaveTerms) {
+        const double arg = (x * w.alongX + z * w.alongZ) * static_cast<double>(w.frequency) + t * w.phaseSpeed;
+        const double height = static_cast<double>(w.height) * kWaveAmplitude;
+        h += height * std::sin(arg);
+        // The argument is formed in float, so it can be off by a couple of its ulps.
+        slack += height * (std::fabs(arg) * 2.4e-7 + 5e-6);
+    }
+    return h + kSeaLevel;
+}
+
+// Every path must match the scalar one bit for bit, for every batch length (the padded
+// tail included), and stay within the argument's rounding of a double-precision sea, from
+// the first tick to hours into a match and far from the origin.
+static bool checkWaveOracle() {
+    Rng rng(2025, 25);
+    std::vector<float> x, z, simd, scalar;
+    size_t tested = 0;
+    double worst = 0.0;
+    for (size_t count : { 0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 1000, 4099 }) {
+        for (float time : { 0.0f, 1.0f / 60.0f, 37.25f, 600.0f, 10800.0f }) {
+            x.resize(count);
+            z.resize(count);
+            simd.assign(count, 0.0f);
+            scalar.assign(count, 0.0f);
+            const float reach = (time > 1000.0f) ? 5000.0f : 600.0f;
+            for (size_t i = 0; i < count; ++i) {
+                x[i] = rng.Range(-reach, reach);
+                z[i] = rng.Range(-reach, reach);
+            }
+            SampleWaveHeights(WaveSamples{ x.data(), z.data(), simd.data(), count }, time);
+            SampleWaveHeightsScalar(WaveSamples{ x.data(), z.data(), scalar.data(), count }, time);
+            for (size_t i = 0; i < count; ++i) {
+                double slack = 0.0;
+                const double want = referenceWaveHeight(x[i], z[i], time, slack);
+                const bool single = (i % 97 != 0) || WaveHeight(x[i], z[i], time) == simd[i];
+                if (std::memcmp(&simd[i], &scalar[i], sizeof(float)) != 0 || !single ||
+                    std::fabs(simd[i] - want) > slack) {
+                    std::cout << "wave oracle MISMATCH: " << WaveSamplePath() << " path, batch of " << count
+                              << ", point " << i << " at t=" << time << ": " << simd[i] << " (scalar " << scalar[i]
+                              << "), want " << want << "\n";
+                    return false;
+                }
+                worst = std::max(worst, std::fabs(simd[i] - want));
+                ++tested;
+            }
+        }
+    }
+    std::cout << "wave oracle: OK (" << tested << " points on the " << WaveSamplePath()
+              << " path, worst error " << std::scientific << worst << std::defaultfloat << ")\n";
+    return true;
+}
+
+// A fleet spread over the play area, four samples a boat per tick: the batched sampler
+// against the same sea summed with std::sin, and the whole buoyancy step.
+static void benchWaves() {
+    std::cout << std::fixed << std::setprecision(3)
+              << "        boats   batched(us/tick)   std::sin(us/tick)   buoyancy(us/tick)\n";
+    for (size_t boats : { 1000, 10000, 100000 }) {
+        Rng rng(88, boats);
+        const size_t n = 4 * boats;
+        std::vector<float> x(n), z(n), h(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = rng.Range(-120.0f, 120.0f);
+            z[i] = rng.Range(-120.0f, 120.0f);
+        }
+        std::vector<float> posX(boats), posZ(boats), bowX(boats), bowZ(boats);
+        std::vector<float> pose(6 * boats, 0.0f);
+        for (size_t i = 0; i < boats; ++i) {
+            posX[i] = x[i];
+            posZ[i] = z[i];
+            const float yaw = rng.Range(-3.14159265f, 3.14159265f);
+            bowX[i] = std::sin(yaw);
+            bowZ[i] = std::cos(yaw);
+        }
+
+        const int ticks = (boats >= 100000) ? 50 : 500;
+        float sink = 0.0f;
+        BenchClock::time_point t = BenchClock::now();
+        for (int tick = 0; tick < ticks; ++tick) {
+            SampleWaveHeights(WaveSamples{ x.data(), z.data(), h.data(), n }, tick / 60.0f);
+            sink += h[tick % n];
+        }
+        const double batchedUs = elapsedSeconds(t) * 1e6 / ticks;
+
+        t = BenchClock::now();
+        for (int tick = 0; tick < ticks; ++tick) {
+            const float time = tick / 60.0f * kWaveSpeed;
+            for (size_t i = 0; i < n; ++i) {
+                float sum = 0.0f;
+                for (const WaveTerm& w : kWaveTerms)
+                    sum += w.height * kWaveAmplitude *
+                           std::sin((x[i] * w.alongX + z[i] * w.alongZ) * w.frequency + time * w.phaseSpeed);
+                h[i] = sum + kSeaLevel;
+            }
+            sink += h[tick % n];
+        }
+        const double stdUs = elapsedSeconds(t) * 1e6 / ticks;
+
+        Buoyancy buoyancy;
+        const BuoyancyArrays arrays{ posX.data(), posZ.data(), bowX.data(), bowZ.data(),
+                                     pose.data(), pose.data() + boats, pose.data() + 2 * boats,
+                                     pose.data() + 3 * boats, pose.data() + 4 * boats, pose.data() + 5 * boats, boats };
+        const BuoyancyParams params{ 5.0f, 2.0f, 16.0f, 4.8f };
+        t = BenchClock::now();
+        for (int tick = 0; tick < ticks; ++tick) buoyancy.Float(arrays, params, tick / 60.0f, 1.0f / 60.0f);
+        const double floatUs = elapsedSeconds(t) * 1e6 / ticks;
+
+        std::cout << std::setw(13) << boats << std::setw(19) << batchedUs << std::setw(20) << stdUs
+                  << std::setw(20) << floatUs << (sink == 12345.0f ? " " : "") << "\n";
+    }
+}
+
+int RunBenchmark(const std::string& name) {
+    if (name == "broadphase") {
+        if (!checkBroadphaseOracle()) return 1;
+        benchBroadphase();
+        return 0;
+    }
+    if (name == "mountains") {
+        if (!checkMountainOracle() || !checkLineOfSightOracle()) return 1;
+        benchMountains();
+        benchLineOfSight();
+        return 0;
+    }
+    if (name == "projectiles") {
+        if (!checkProjectilePoolOracle()) return 1;
+        benchProjectilePool();
+        return 0;
+    }
+    if (name == "enemies") {
+        if (!checkEnemySteerOracle()) return 1;
+        benchEnemySteer();
+        return 0;
+    }
+    if (name == "flocking") {
+        if (!checkFlockingOracle()) return 1;
+        benchFlocking();
+        return 0;
+    }
+    if (name == "navfield") {
+        if (!checkNavFieldOracle()) return 1;
+        benchNavField();
+        return 0;
+    }
+    if (name == "behaviors") {
+        if (!checkBehaviorOracle()) return 1;
+        benchBehaviors();
+        return 0;
+    }
+    if (name == "timers") {
+        if (!checkTimerWheelOracle()) return 1;
+        benchTimerWheel();
+        return 0;
+    }
+    if (name == "ballistics") {
+        if (!checkInterceptOracle() || !checkLazyHitOracle()) return 1;
+        benchBallistics();
+        return 0;
+    }
+    if (name == "hulls") {
+        if (!checkHullOracle()) return 1;
+        benchHulls();
+        return 0;
+    }
+    if (name == "waves") {
+        if (!checkWaveOracle()) return 1;
+        benchWaves();
+        return 0;
+    }
+    if (name == "jobs") {
+        if (!checkJobSystemOracle()) return 1;
+        benchParallelSteer();
+        return 0;
+    }
+    std::cout << "Unknown benchmark '" << name << "'. Available: broadphase, mountains, projectiles, enemies, "
+                 "flocking, navfield, behaviors, timers, ballistics, hulls, waves, jobs\n";
+    return 1;
+}
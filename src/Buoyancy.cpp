@@ -0,0 +1,45 @@
+#include "Buoyancy.h"
+#include "Ballistics.h"
+#include "Waves.h"
+#include <cmath>
+
+// Semi-implicit Euler: the rate is updated first and the new rate moves the value, which
+// stays stable for the stiffness and tick lengths the game uses.
+static void spring(float& value, float& rate, float target, const BuoyancyParams& p, float dt) {
+    rate += (p.stiffness * (target - value) - p.damping * rate) * dt;
+    value += rate * dt;
+}
+
+void Buoyancy::Float(const BuoyancyArrays& b, const BuoyancyParams& p, float time, float dt) {
+    const size_t n = b.count;
+    if (n == 0) return;
+    sampleX.resize(4 * n);
+    sampleZ.resize(4 * n);
+    sampleHeight.resize(4 * n);
+
+    // Four runs of n points: bows, sterns, sides at (bowZ, -bowX), the opposite sides.
+    const float halfLength = 0.5f * p.length, halfBeam = 0.5f * p.beam;
+    float* x = sampleX.data();
+    float* z = sampleZ.data();
+    for (size_t i = 0; i < n; ++i) {
+        const float fx = b.bowX[i] * halfLength, fz = b.bowZ[i] * halfLength;
+        const float sx = b.bowZ[i] * halfBeam,   sz = -b.bowX[i] * halfBeam;
+        x[i]         = b.posX[i] + fx;  z[i]         = b.posZ[i] + fz;
+        x[n + i]     = b.posX[i] - fx;  z[n + i]     = b.posZ[i] - fz;
+        x[2 * n + i] = b.posX[i] + sx;  z[2 * n + i] = b.posZ[i] + sz;
+        x[3 * n + i] = b.posX[i] - sx;  z[3 * n + i] = b.posZ[i] - sz;
+    }
+    SampleWaveHeights(WaveSamples{ x, z, sampleHeight.data(), 4 * n }, time);
+    samples += 4 * n;
+
+    const float* h = sampleHeight.data();
+    for (size_t i = 0; i < n; ++i) {
+        const float bow = h[i], stern = h[n + i], side = h[2 * n + i], otherSide = h[3 * n + i];
+        const float heave = 0.25f * (bow + stern + side + otherSide) - kSeaLevel;
+        const float pitch = std::atan((bow - stern) / p.length);
+        const float roll  = std::atan((side - otherSide) / p.beam);
+        spring(b.heave[i], b.heaveRate[i], heave, p, dt);
+        spring(b.pitch[i], b.pitchRate[i], pitch, p, dt);
+        spring(b.roll[i],  b.rollRate[i],  roll,  p, dt);
+    }
+}
@@ -0,0 +1,236 @@
+#include "EnemyKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// Every path does the same IEEE operations in the same order (no reciprocal estimates,
+// exact sqrt and divide), so they agree bit for bit. When FMA is enabled GCC would otherwise
+// fuse a*b+c, intrinsics included, into FMA wherever it likes, rounding some paths differently.
+#if defined(__GNUC__) && !defined(__clang__)
+#define NO_FP_CONTRACT __attribute__((optimize("fp-contract=off")))
+#else
+#define NO_FP_CONTRACT
+#endif
+
+static constexpr float kFaceMinDistance = 0.1f;
+
+namespace {
+
+// Derived once per call so every path uses the same rounded values.
+struct StepConstants {
+    float seekDistance;
+    float fleeSpeed; // signed: backing off
+};
+
+StepConstants stepConstants(const EnemySteerParams& p) {
+    return StepConstants{ p.keepAway + p.approachSlack, -(p.speed * 0.5f) };
+}
+
+} // namespace
+
+NO_FP_CONTRACT
+static void steerScalarRange(const EnemySteerArrays& a, const EnemySteerParams& p, size_t begin, size_t end) {
+    const StepConstants k = stepConstants(p);
+    for (size_t i = begin; i < end; ++i) {
+        a.fire[i] = 0;
+        if (!a.active[i]) continue;
+
+        const float dt = a.dt[i];
+
+        const float dx = p.playerX - a.posX[i];
+        const float dy = p.playerY - a.posY[i];
+        const float dz = p.playerZ - a.posZ[i];
+        const float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+        const float inv  = 1.0f / dist;
+
+        const bool seek = dist > k.seekDistance;
+        const bool flee = dist < p.keepAway && dist > 0.0f;
+        const float step = seek ? p.speed * dt : k.fleeSpeed * dt;
+        const float mx = (seek || flee) ? (dx * inv) * step : 0.0f;
+        const float my = (seek || flee) ? (dy * inv) * step : 0.0f;
+        const float mz = (seek || flee) ? (dz * inv) * step : 0.0f;
+        a.posX[i] = a.posX[i] + mx;
+        a.posY[i] = a.posY[i] + my;
+        a.posZ[i] = a.posZ[i] + mz;
+
+        const float flat = std::sqrt(dx * dx + dz * dz);
+        const float invFlat = 1.0f / flat;
+        if (dist > kFaceMinDistance && flat > 0.0f) {
+            a.faceX[i] = dx * invFlat;
+            a.faceZ[i] = dz * invFlat;
+        }
+
+        a.fire[i] = (dist <= p.fireRange && dist > p.keepAway && a.armed[i]) ? 1 : 0;
+    }
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+// Four flag bytes (active, armed) widened to an all-ones / all-zeros float mask.
+static __m128 activeMask4(const uint8_t* active) {
+    int32_t bytes;
+    std::memcpy(&bytes, active, 4);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i v = _mm_cvtsi32_si128(bytes);
+    v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+    return _mm_castsi128_ps(_mm_cmpgt_epi32(v, zero));
+}
+
+// The four-wide kernel only runs in SSE2 builds; AVX builds use steerAvx8 throughout.
+#if !defined(__AVX__)
+static __m128 select4(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+NO_FP_CONTRACT
+static void steerSse4(const EnemySteerArrays& a, const EnemySteerParams& p, const StepConstants& k, size_t i) {
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 active = activeMask4(a.active + i);
+
+    const __m128 dt = _mm_loadu_ps(a.dt + i);
+
+    const __m128 x = _mm_loadu_ps(a.posX + i), y = _mm_loadu_ps(a.posY + i), z = _mm_loadu_ps(a.posZ + i);
+    const __m128 dx = _mm_sub_ps(_mm_set1_ps(p.playerX), x);
+    const __m128 dy = _mm_sub_ps(_mm_set1_ps(p.playerY), y);
+    const __m128 dz = _mm_sub_ps(_mm_set1_ps(p.playerZ), z);
+    const __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+    const __m128 inv  = _mm_div_ps(one, dist);
+
+    const __m128 keepAway = _mm_set1_ps(p.keepAway);
+    const __m128 seek = _mm_cmpgt_ps(dist, _mm_set1_ps(k.seekDistance));
+    const __m128 flee = _mm_and_ps(_mm_cmplt_ps(dist, keepAway), _mm_cmpgt_ps(dist, zero));
+    const __m128 moving = _mm_or_ps(seek, flee);
+    const __m128 step = select4(seek, _mm_mul_ps(_mm_set1_ps(p.speed), dt), _mm_mul_ps(_mm_set1_ps(k.fleeSpeed), dt));
+    const __m128 nx = _mm_add_ps(x, _mm_and_ps(moving, _mm_mul_ps(_mm_mul_ps(dx, inv), step)));
+    const __m128 ny = _mm_add_ps(y, _mm_and_ps(moving, _mm_mul_ps(_mm_mul_ps(dy, inv), step)));
+    const __m128 nz = _mm_add_ps(z, _mm_and_ps(moving, _mm_mul_ps(_mm_mul_ps(dz, inv), step)));
+    _mm_storeu_ps(a.posX + i, select4(active, nx, x));
+    _mm_storeu_ps(a.posY + i, select4(active, ny, y));
+    _mm_storeu_ps(a.posZ + i, select4(active, nz, z));
+
+    const __m128 flat = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz)));
+    const __m128 face = _mm_and_ps(active, _mm_and_ps(_mm_cmpgt_ps(dist, _mm_set1_ps(kFaceMinDistance)),
+                                                      _mm_cmpgt_ps(flat, zero)));
+    const __m128 invFlat = _mm_div_ps(one, flat);
+    _mm_storeu_ps(a.faceX + i, select4(face, _mm_mul_ps(dx, invFlat), _mm_loadu_ps(a.faceX + i)));
+    _mm_storeu_ps(a.faceZ + i, select4(face, _mm_mul_ps(dz, invFlat), _mm_loadu_ps(a.faceZ + i)));
+
+    const __m128 fire = _mm_and_ps(active, _mm_and_ps(_mm_and_ps(_mm_cmple_ps(dist, _mm_set1_ps(p.fireRange)),
+                                                                 _mm_cmpgt_ps(dist, keepAway)),
+                                                      activeMask4(a.armed + i)));
+    const int fireBits = _mm_movemask_ps(fire);
+    for (int l = 0; l < 4; ++l) a.fire[i + l] = static_cast<uint8_t>((fireBits >> l) & 1);
+}
+#endif // !__AVX__
+#endif
+
+#if defined(__AVX__)
+static __m256 activeMask8(const uint8_t* active) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(activeMask4(active)), activeMask4(active + 4), 1);
+}
+
+NO_FP_CONTRACT
+static void steerAvx8(const EnemySteerArrays& a, const EnemySteerParams& p, const StepConstants& k, size_t i) {
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    const __m256 active = activeMask8(a.active + i);
+
+    const __m256 dt = _mm256_loadu_ps(a.dt + i);
+
+    const __m256 x = _mm256_loadu_ps(a.posX + i), y = _mm256_loadu_ps(a.posY + i), z = _mm256_loadu_ps(a.posZ + i);
+    const __m256 dx = _mm256_sub_ps(_mm256_set1_ps(p.playerX), x);
+    const __m256 dy = _mm256_sub_ps(_mm256_set1_ps(p.playerY), y);
+    const __m256 dz = _mm256_sub_ps(_mm256_set1_ps(p.playerZ), z);
+    const __m256 dist = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                                                     _mm256_mul_ps(dz, dz)));
+    const __m256 inv  = _mm256_div_ps(one, dist);
+
+    const __m256 keepAway = _mm256_set1_ps(p.keepAway);
+    const __m256 seek = _mm256_cmp_ps(dist, _mm256_set1_ps(k.seekDistance), _CMP_GT_OQ);
+    const __m256 flee = _mm256_and_ps(_mm256_cmp_ps(dist, keepAway, _CMP_LT_OQ), _mm256_cmp_ps(dist, zero, _CMP_GT_OQ));
+    const __m256 moving = _mm256_or_ps(seek, flee);
+    const __m256 step = _mm256_blendv_ps(_mm256_mul_ps(_mm256_set1_ps(k.fleeSpeed), dt),
+                                         _mm256_mul_ps(_mm256_set1_ps(p.speed), dt), seek);
+    const __m256 nx = _mm256_add_ps(x, _mm256_and_ps(moving, _mm256_mul_ps(_mm256_mul_ps(dx, inv), step)));
+    const __m256 ny = _mm256_add_ps(y, _mm256_and_ps(moving, _mm256_mul_ps(_mm256_mul_ps(dy, inv), step)));
+    const __m256 nz = _mm256_add_ps(z, _mm256_and_ps(moving, _mm256_mul_ps(_mm256_mul_ps(dz, inv), step)));
+    _mm256_storeu_ps(a.posX + i, _mm256_blendv_ps(x, nx, active));
+    _mm256_storeu_ps(a.posY + i, _mm256_blendv_ps(y, ny, active));
+    _mm256_storeu_ps(a.posZ + i, _mm256_blendv_ps(z, nz, active));
+
+    const __m256 flat = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dz, dz)));
+    const __m256 face = _mm256_and_ps(active, _mm256_and_ps(_mm256_cmp_ps(dist, _mm256_set1_ps(kFaceMinDistance), _CMP_GT_OQ),
+                                                            _mm256_cmp_ps(flat, zero, _CMP_GT_OQ)));
+    const __m256 invFlat = _mm256_div_ps(one, flat);
+    _mm256_storeu_ps(a.faceX + i, _mm256_blendv_ps(_mm256_loadu_ps(a.faceX + i), _mm256_mul_ps(dx, invFlat), face));
+    _mm256_storeu_ps(a.faceZ + i, _mm256_blendv_ps(_mm256_loadu_ps(a.faceZ + i), _mm256_mul_ps(dz, invFlat), face));
+
+    const __m256 inRange = _mm256_and_ps(_mm256_cmp_ps(dist, _mm256_set1_ps(p.fireRange), _CMP_LE_OQ),
+                                         _mm256_cmp_ps(dist, keepAway, _CMP_GT_OQ));
+    const __m256 fire = _mm256_and_ps(active, _mm256_and_ps(inRange, activeMask8(a.armed + i)));
+    const int fireBits = _mm256_movemask_ps(fire);
+    for (int l = 0; l < 8; ++l) a.fire[i + l] = static_cast<uint8_t>((fireBits >> l) & 1);
+}
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+// The last few boats are copied into a padded block and run through the same vector code,
+// so no boat ever takes the scalar path in a SIMD build.
+template <size_t Width, typename Kernel>
+static void steerTail(const EnemySteerArrays& a, const EnemySteerParams& p, const StepConstants& k,
+                      size_t begin, Kernel kernel) {
+    const size_t n = a.count - begin;
+    if (n == 0) return;
+    float x[Width] = {}, y[Width] = {}, z[Width] = {}, fx[Width] = {}, fz[Width] = {}, dt[Width] = {};
+    uint8_t active[Width] = {}, armed[Width] = {}, fire[Width] = {};
+    std::copy_n(a.posX + begin, n, x);
+    std::copy_n(a.posY + begin, n, y);
+    std::copy_n(a.posZ + begin, n, z);
+    std::copy_n(a.faceX + begin, n, fx);
+    std::copy_n(a.faceZ + begin, n, fz);
+    std::copy_n(a.dt + begin, n, dt);
+    std::copy_n(a.active + begin, n, active);
+    std::copy_n(a.armed + begin, n, armed);
+
+    const EnemySteerArrays block{ x, y, z, armed, fx, fz, dt, active, fire, Width };
+    kernel(block, p, k, 0);
+
+    std::copy_n(x, n, a.posX + begin);
+    std::copy_n(y, n, a.posY + begin);
+    std::copy_n(z, n, a.posZ + begin);
+    std::copy_n(fx, n, a.faceX + begin);
+    std::copy_n(fz, n, a.faceZ + begin);
+    std::copy_n(fire, n, a.fire + begin);
+}
+#endif
+
+void SteerEnemies(const EnemySteerArrays& a, const EnemySteerParams& p) {
+#if defined(__AVX__)
+    const StepConstants k = stepConstants(p);
+    size_t i = 0;
+    for (; i + 8 <= a.count; i += 8) steerAvx8(a, p, k, i);
+    steerTail<8>(a, p, k, i, steerAvx8);
+#elif defined(__SSE2__) || defined(_M_X64)
+    const StepConstants k = stepConstants(p);
+    size_t i = 0;
+    for (; i + 4 <= a.count; i += 4) steerSse4(a, p, k, i);
+    steerTail<4>(a, p, k, i, steerSse4);
+#else
+    steerScalarRange(a, p, 0, a.count);
+#endif
+}
+
+void SteerEnemiesScalar(const EnemySteerArrays& a, const EnemySteerParams& p) {
+    steerScalarRange(a, p, 0, a.count);
+}
+
+const char* EnemySteerPath() {
+#if defined(__AVX__)
+    return "avx";
+#elif defined(__SSE2__) || defined(_M_X64)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -1,85 +1,592 @@
 #include "EnemyManager.h"
 #include "ProjectileManager.h"
 #include "MountainManager.h"
-#include <random>
+#include "Random.h"
+#include "EnemyKernel.h"
+#include "Flocking.h"
+#include "JobSystem.h"
+#include "Ballistics.h"
 #include <iostream>
 #include <glm/gtc/constants.hpp>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 
-static const float SPAWN_RADIUS_MIN = 60.0f;
-static const float SPAWN_RADIUS_MAX = 100.0f;
+static constexpr float SPAWN_RADIUS_MIN = 60.0f;
+static constexpr float SPAWN_RADIUS_MAX = 100.0f;
 
-EnemyManager::EnemyManager() : spawnTimer(0.0f), currentDifficulty(EASY), maxEnemies(30) {}
+// Spawning: once a second a batch of positions is drawn at least kSpawnSpacing apart
+// (from each other and from every boat already there), then released kSpawnsPerTick at
+// a time so no single tick pays for the whole wave.
+static constexpr float  kSpawnSpacing      = 5.0f;
+static constexpr size_t kSpawnsPerTick     = 4;
+static constexpr size_t kSpawnCandidates   = 32;  // drawn and mountain-tested together
+static constexpr size_t kSpawnTriesPerBoat = 50;
+static constexpr float  kFirstWaveSeconds  = 4.0f;
+static constexpr float  kWaveSeconds       = 1.0f;  // from drawing one batch to the next
 
-void EnemyManager::Init(Difficulty difficulty) {
+static constexpr float kEnemySpeed         = 2.0f;
+static constexpr float kEnemyMaxCooldown   = 2.0f;  // seconds from one shot to the next
+static constexpr float kStrafeSeconds      = 0.75f; // of that, spent swinging out sideways
+static constexpr float kMinPlayerDistance  = 5.0f;
+static constexpr float kApproachSlack      = 3.0f;
+static constexpr float kFireRange          = 25.0f;
+static constexpr float kBoatRadius         = 1.0f;
+static constexpr float kShellSpeed         = 18.0f; // muzzle speed; reaches about 33 units at 45 degrees
+static constexpr float kMuzzleHeight       = 0.55f; // above the boat
+static constexpr float kAimHeight          = 0.5f;  // above the player's position
+static constexpr float kSightClearance     = 0.5f;  // a sight line this close to a mountain is blocked
+static constexpr size_t kEnemyChunk         = 256;  // boats per parallel task, a multiple of the SIMD width
+
+// AI level of detail. Only near boats can fire, so they are stepped every tick exactly as
+// before; further out a boat is stepped less often, with dt covering the ticks it skipped.
+static constexpr float    kNearAiRadius  = 35.0f;  // fire range plus room to close in
+static constexpr float    kMidAiRadius   = 70.0f;
+static constexpr uint32_t kMidAiInterval = 4;      // ticks between mid-range steps
+static constexpr size_t   kFarAiBudget   = 16;     // far boats stepped per tick
+
+// Flocking on top of the seek / flee steering, so boats spread out instead of stacking
+// on the same spot. Separation dominates; the capped neighbor count keeps it linear.
+static constexpr FlockParams kFlock{ 6.0f,   // radius
+                                     3.0f,   // separationRadius
+                                     8,      // maxNeighbors
+                                     2.0f,   // separationWeight
+                                     0.3f,   // alignmentWeight
+                                     0.3f,   // cohesionWeight
+                                     kEnemySpeed };
+
+// Interest management: a boat that strays past kSleepRadius is parked in the dormant pool
+// instead of being dropped, and comes back inside kWakeRadius (the gap stops boats on the
+// edge flickering between the two). Parked boats are forgotten past kForgetRadius.
+static constexpr float    kSleepRadius      = SPAWN_RADIUS_MAX + 20.0f;
+static constexpr float    kWakeRadius       = SPAWN_RADIUS_MAX + 10.0f;
+static constexpr float    kForgetRadius     = 1000.0f;
+static constexpr size_t   kMaxDormant       = 4096;
+static constexpr uint32_t kDormantStepTicks = 30;     // ticks for a full pass over the pool
+static constexpr float    kDormantXZScale   = 16.0f;  // DormantBoat position units per world unit
+static constexpr float    kDormantYScale    = 256.0f;
+
+// The drawn hull is ModelManager::kBoatScale long. Heave, pitch and roll settle in about a
+// second (omega 4 /s, damping ratio 0.6), so the boats ride the swell rather than snap to it.
+static constexpr BuoyancyParams kEnemyBuoyancy{ 5.0f, 2.0f, 16.0f, 4.8f };
+
+// Navigation: boats closing in on the player follow a shared flow field around the
+// mountains. 64 cells of 4 units reach past the despawn radius on every side.
+static constexpr int   kNavCells    = 64;
+static constexpr float kNavCellSize = 4.0f;
+
+// EnemyStore
+float EnemyStore::RotationDeg(size_t i) const {
+    return std::atan2(faceX[i], faceZ[i]) * 180.0f / glm::pi<float>();
+}
+
+float EnemyStore::PrevRotationDeg(size_t i) const {
+    return std::atan2(prevFaceX[i], prevFaceZ[i]) * 180.0f / glm::pi<float>();
+}
+
+void EnemyStore::Push(const glm::vec3& pos) {
+    posX.push_back(pos.x);
+    posY.push_back(pos.y);
+    posZ.push_back(pos.z);
+    armed.push_back(0);
+    strafe.push_back(0);
+    faceX.push_back(0.0f);
+    faceZ.push_back(1.0f);
+    active.push_back(1);
+    maxCooldown.push_back(kEnemyMaxCooldown);
+    prevPosition.push_back(pos);
+    prevFaceX.push_back(0.0f);
+    prevFaceZ.push_back(1.0f);
+    lastThink.push_back(0);
+    behavior.push_back(0);
+    for (auto* v : { &heave, &pitch, &roll, &heaveRate, &pitchRate, &rollRate }) v->push_back(0.0f);
+}
+
+void EnemyStore::Clear() { resize(0); }
+
+void EnemyStore::move(size_t from, size_t to) {
+    posX[to] = posX[from];
+    posY[to] = posY[from];
+    posZ[to] = posZ[from];
+    armed[to] = armed[from];
+    strafe[to] = strafe[from];
+    faceX[to] = faceX[from];
+    faceZ[to] = faceZ[from];
+    active[to] = active[from];
+    maxCooldown[to] = maxCooldown[from];
+    prevPosition[to] = prevPosition[from];
+    prevFaceX[to] = prevFaceX[from];
+    prevFaceZ[to] = prevFaceZ[from];
+    lastThink[to] = lastThink[from];
+    behavior[to] = behavior[from];
+    heave[to] = heave[from];
+    pitch[to] = pitch[from];
+    roll[to] = roll[from];
+    heaveRate[to] = heaveRate[from];
+    pitchRate[to] = pitchRate[from];
+    rollRate[to] = rollRate[from];
+}
+
+void EnemyStore::resize(size_t n) {
+    posX.resize(n);
+    posY.resize(n);
+    posZ.resize(n);
+    armed.resize(n);
+    strafe.resize(n);
+    faceX.resize(n);
+    faceZ.resize(n);
+    active.resize(n);
+    maxCooldown.resize(n);
+    prevPosition.resize(n);
+    prevFaceX.resize(n);
+    prevFaceZ.resize(n);
+    lastThink.resize(n);
+    behavior.resize(n);
+    for (auto* v : { &heave, &pitch, &roll, &heaveRate, &pitchRate, &rollRate }) v->resize(n);
+}
+
+// EnemyManager
+EnemyManager::EnemyManager()
+    : currentDifficulty(EASY), maxEnemies(30), spawnGrid(kSpawnSpacing), flockGrid(kFlock.radius),
+      navField(kNavCells, kNavCellSize, kBoatRadius) {}
+
+void EnemyManager::Init(Difficulty difficulty, Rng& randomStream) {
     currentDifficulty = difficulty;
-    enemies.clear();
+    rng = &randomStream;
+    behaviors.Reset();
+    behaviorBoat.clear();
+    enemies.Clear();
     maxEnemies = (currentDifficulty == EASY) ? 100 : 200;
-    spawnTimer = -3.0f; 
+    thinkTick = 0;
+    farCursor = 0;
+    destroyedPending = 0;
+    retired = 0;
+    pendingSpawns.clear();
+    nextSpawn = 0;
+    waveDue = false;
+    waveTask = behaviors.Start(waveBehavior());
+    dormant.clear();
+    dormantCursor = 0;
+    lastPlayerPosition = glm::vec3(0.0f);
+    playerVelocity = glm::vec3(0.0f);
+    aiStats = EnemyAiStats();
+    navField.Init();
+}
+
+template <typename Pred>
+void EnemyManager::removeBoats(Pred remove) {
+    const size_t before = enemies.Size();
+    enemies.RemoveIf([&](size_t i) {
+        if (!remove(i)) return false;
+        behaviors.Stop(enemies.behavior[i]);
+        return true;
+    });
+    if (enemies.Size() == before) return;
+    for (size_t i = 0; i < enemies.Size(); ++i) behaviorBoat[enemies.behavior[i]] = static_cast<uint32_t>(i);
 }
 
-void EnemyManager::Update(float dt, const glm::vec3& playerPosition, ProjectileManager& projectileManager, MountainManager& mountainManager) {
-    enemies.erase(std::remove_if(enemies.begin(), enemies.end(),
-        [&](const EnemyBoat& e){ return glm::length(e.position - playerPosition) > SPAWN_RADIUS_MAX + 20.0f; }),
-        enemies.end());
+void EnemyManager::Think(float dt, const glm::vec3& playerPosition, const MountainManager& mountainManager) {
+    ++thinkTick;
+    tickSeconds = dt;
+    playerVelocity = (thinkTick > 1 && dt > 0.0f) ? (playerPosition - lastPlayerPosition) / dt : glm::vec3(0.0f);
+    lastPlayerPosition = playerPosition;
+    removeBoats([&](size_t i) {
+        const float dx = enemies.posX[i] - playerPosition.x, dz = enemies.posZ[i] - playerPosition.z;
+        if (dx * dx + dz * dz <= kSleepRadius * kSleepRadius) return false;
+        putToSleep(i);
+        return true;
+    });
+    behaviors.RunUntil(thinkTick);
 
-    // Spawn
-    spawnTimer += dt;
-    if (spawnTimer >= 1.0f && enemies.size() < static_cast<size_t>(maxEnemies)) {
-        const int toSpawn = (currentDifficulty == EASY) ? 10 : 20;
-        for (int i = 0; i < toSpawn && enemies.size() < static_cast<size_t>(maxEnemies); ++i) {
-            SpawnEnemy(playerPosition, mountainManager);
+    // Parked boats coming back in range take their place under the cap before new ones.
+    stepDormant(playerPosition, mountainManager);
+    const size_t cap = static_cast<size_t>(maxEnemies);
+    if (waveDue && enemies.Size() < cap) {
+        const size_t toSpawn = (currentDifficulty == EASY) ? 10 : 20;
+        sampleSpawnBatch(playerPosition, mountainManager, std::min(toSpawn, cap - enemies.Size()));
+        waveDue = false;
+        behaviors.Signal(waveTask);
+    }
+    for (size_t k = 0; k < kSpawnsPerTick && nextSpawn < pendingSpawns.size() && enemies.Size() < cap; ++k) {
+        spawn(pendingSpawns[nextSpawn++]);
+        ++aiStats.spawned;
+    }
+
+    navField.Refresh(playerPosition, mountainManager);
+    pickBoatsToStep(playerPosition);
+    const size_t count = toStep.size();
+    for (auto* v : { &stepX, &stepY, &stepZ, &stepFaceX, &stepFaceZ, &stepDt }) v->resize(count);
+    stepArmed.resize(count);
+    stepActive.assign(count, 1);
+    fireNow.resize(count);
+    moveTo.resize(count);
+    moveBlocked.resize(count);
+
+    // Think / move / pick shots in parallel chunks. Each thread collects its shots in its
+    // own buffer; they are merged by enemy index so the projectile order never depends on
+    // the thread count or on which thread ran which chunk.
+    const unsigned threads = jobs ? jobs->ThreadCount() : 1;
+    if (fireBuffers.size() < threads) fireBuffers.resize(threads);
+    for (auto& buffer : fireBuffers) buffer.clear();
+
+    auto step = [&](size_t begin, size_t end, unsigned slot) {
+        stepRange(begin, end, playerPosition, dt, mountainManager, fireBuffers[slot]);
+    };
+    if (jobs) jobs->ParallelFor(count, kEnemyChunk, step);
+    else      step(0, count, 0);
+
+    // Each shooter's behavior picks up where it waited for the shot, in boat order.
+    fireMerged.clear();
+    for (const auto& buffer : fireBuffers) fireMerged.insert(fireMerged.end(), buffer.begin(), buffer.end());
+    std::sort(fireMerged.begin(), fireMerged.end(),
+              [](const FireRequest& a, const FireRequest& b) { return a.enemy < b.enemy; });
+    dropBlockedShots(playerPosition, mountainManager);
+    aimShots(playerPosition);
+    for (const FireRequest& f : fireMerged) behaviors.Signal(enemies.behavior[f.enemy]);
+}
+
+// Boats with a mountain between them and the player hold their fire: one batched query
+// over every shot this tick, and the blocked boats stay loaded to try again next tick.
+void EnemyManager::dropBlockedShots(const glm::vec3& playerPosition, const MountainManager& mountainManager) {
+    const size_t n = fireMerged.size();
+    if (n == 0) return;
+    for (auto* v : { &sightX, &sightZ }) v->resize(n);
+    sightToX.assign(n, playerPosition.x);
+    sightToZ.assign(n, playerPosition.z);
+    sightBlocked.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        sightX[k] = fireMerged[k].muzzle.x;
+        sightZ[k] = fireMerged[k].muzzle.z;
+    }
+    const SightLines lines{ sightX.data(), sightZ.data(), sightToX.data(), sightToZ.data(), sightBlocked.data(), n };
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const size_t blocked = mountainManager.checkLineOfSightBatch(lines, kSightClearance);
+    aiStats.sightSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    aiStats.sightLines += n;
+    aiStats.sightBlocked += blocked;
+    if (blocked == 0) return;
+
+    size_t kept = 0;
+    for (size_t k = 0; k < n; ++k) {
+        if (sightBlocked[k]) enemies.armed[fireMerged[k].enemy] = 1;
+        else                 fireMerged[kept++] = fireMerged[k];
+    }
+    fireMerged.resize(kept);
+}
+
+// Every shot this tick in one batch, leading the player by their velocity since last tick.
+void EnemyManager::aimShots(const glm::vec3& playerPosition) {
+    const size_t n = fireMerged.size();
+    if (n == 0) return;
+    for (auto* v : { &aimX, &aimY, &aimZ, &aimVelX, &aimVelY, &aimVelZ, &aimTime }) v->resize(n);
+    aimInRange.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        aimX[k] = fireMerged[k].muzzle.x;
+        aimY[k] = fireMerged[k].muzzle.y;
+        aimZ[k] = fireMerged[k].muzzle.z;
+    }
+    const InterceptArrays arrays{ aimX.data(), aimY.data(), aimZ.data(), aimVelX.data(), aimVelY.data(), aimVelZ.data(),
+                                  aimTime.data(), aimInRange.data(), n };
+    const InterceptParams params{ playerPosition.x, playerPosition.y + kAimHeight, playerPosition.z,
+                                  playerVelocity.x, playerVelocity.z, kShellSpeed };
+    const size_t inRange = SolveIntercepts(arrays, params);
+    for (size_t k = 0; k < n; ++k) fireMerged[k].velocity = glm::vec3(aimVelX[k], aimVelY[k], aimVelZ[k]);
+    aiStats.shellsFired += n;
+    aiStats.shellsOutOfRange += n - inRange;
+}
+
+// Between shots a boat's gun costs nothing per tick: the task sleeps on the scheduler's
+// timers and waits for Think's signal, and the kernel only reads the armed flag.
+BehaviorTask EnemyManager::gunnerBehavior(uint32_t reloadTicks) {
+    const uint32_t self = behaviors.Current();
+    if (reloadTicks > 0) co_await behaviors.Sleep(reloadTicks);
+    for (;;) {
+        enemies.armed[behaviorBoat[self]] = 1;
+        co_await behaviors.WaitSignal(); // the boat fired; stepRange has disarmed it
+
+        const size_t i = behaviorBoat[self];
+        const uint32_t reload = ticksFor(enemies.maxCooldown[i]);
+        const uint32_t swing  = std::min(ticksFor(kStrafeSeconds), reload);
+        enemies.strafe[i] = (rng->NextU32() & 1u) ? 1 : -1;
+        co_await behaviors.Sleep(swing);
+
+        enemies.strafe[behaviorBoat[self]] = 0;
+        if (reload > swing) co_await behaviors.Sleep(reload - swing);
+    }
+}
+
+// Started by Init at tick 0, so its first resume is tick 1. While the fleet is at its cap
+// the flag just stays up until Think has room to draw the batch.
+BehaviorTask EnemyManager::waveBehavior() {
+    co_await behaviors.Sleep(ticksFor(kFirstWaveSeconds) - 1);
+    for (;;) {
+        waveDue = true;
+        co_await behaviors.WaitSignal(); // Think drew the batch
+        co_await behaviors.Sleep(ticksFor(kWaveSeconds));
+    }
+}
+
+uint32_t EnemyManager::ticksFor(float seconds) const {
+    return TicksFor(seconds, tickSeconds);
+}
+
+void EnemyManager::spawn(const glm::vec3& position, uint32_t reloadTicks) {
+    enemies.Push(position);
+    enemies.lastThink.back() = thinkTick - 1; // stepped from the tick it appears
+    const uint32_t id = behaviors.Start(gunnerBehavior(reloadTicks));
+    if (behaviorBoat.size() <= id) behaviorBoat.resize(id + 1);
+    behaviorBoat[id] = static_cast<uint32_t>(enemies.Size() - 1);
+    enemies.behavior.back() = id;
+}
+
+// Called from removeBoats, which stops the boat's behavior. A boat that isn't armed went
+// to sleep mid-reload; it is given a full reload from here, counted down while parked.
+void EnemyManager::putToSleep(size_t i) {
+    ++aiStats.slept;
+    if (dormant.size() >= kMaxDormant) {
+        ++aiStats.forgotten;
+        return;
+    }
+    const float yaw = std::atan2(enemies.faceX[i], enemies.faceZ[i]);
+    DormantBoat b;
+    b.x = static_cast<int32_t>(std::lround(enemies.posX[i] * kDormantXZScale));
+    b.z = static_cast<int32_t>(std::lround(enemies.posZ[i] * kDormantXZScale));
+    b.y = static_cast<int16_t>(std::lround(enemies.posY[i] * kDormantYScale));
+    b.lastStep = thinkTick;
+    b.heading = static_cast<uint8_t>(std::lround(yaw * (128.0f / glm::pi<float>())) & 255);
+    b.reload = enemies.armed[i] ? 0 : static_cast<uint8_t>(std::min(ticksFor(enemies.maxCooldown[i]), 255u));
+    dormant.push_back(b);
+}
+
+// Advances the next slice of the dormant pool: each boat heads straight for the player over
+// the ticks since its last step, ignoring the mountains. Inside kWakeRadius it comes back
+// as a live boat if there is room under the cap and it is clear of the mountains; until
+// then it holds its position. Removal swaps the last boat in, so the rotation is approximate.
+void EnemyManager::stepDormant(const glm::vec3& playerPosition, const MountainManager& mountainManager) {
+    const size_t slice = (dormant.size() + kDormantStepTicks - 1) / kDormantStepTicks;
+    const size_t cap = static_cast<size_t>(maxEnemies);
+    for (size_t stepped = 0; stepped < slice && !dormant.empty(); ++stepped) {
+        if (dormantCursor >= dormant.size()) dormantCursor = 0;
+        DormantBoat& b = dormant[dormantCursor];
+        const uint32_t elapsed = thinkTick - b.lastStep;
+        b.lastStep = thinkTick;
+        b.reload = static_cast<uint8_t>(b.reload > elapsed ? b.reload - elapsed : 0);
+
+        glm::vec3 pos(b.x / kDormantXZScale, b.y / kDormantYScale, b.z / kDormantXZScale);
+        const float dx = playerPosition.x - pos.x, dz = playerPosition.z - pos.z;
+        const float dist = std::sqrt(dx * dx + dz * dz);
+        if (dist > kForgetRadius) {
+            ++aiStats.forgotten;
+            dormant[dormantCursor] = dormant.back();
+            dormant.pop_back();
+            continue;
         }
-        spawnTimer = 0.0f;
+        if (dist <= kWakeRadius) {
+            if (enemies.Size() < cap && !mountainManager.checkCollision(pos, kBoatRadius)) {
+                const float yaw = b.heading * (glm::pi<float>() / 128.0f);
+                spawn(pos, b.reload);
+                enemies.faceX.back() = enemies.prevFaceX.back() = std::sin(yaw);
+                enemies.faceZ.back() = enemies.prevFaceZ.back() = std::cos(yaw);
+                ++aiStats.woken;
+                dormant[dormantCursor] = dormant.back();
+                dormant.pop_back();
+                continue;
+            }
+        } else if (dist > 0.0f) {
+            const float move = std::min(kEnemySpeed * static_cast<float>(elapsed) * tickSeconds, dist - kWakeRadius);
+            pos.x += dx / dist * move;
+            pos.z += dz / dist * move;
+            b.x = static_cast<int32_t>(std::lround(pos.x * kDormantXZScale));
+            b.z = static_cast<int32_t>(std::lround(pos.z * kDormantXZScale));
+            b.heading = static_cast<uint8_t>(std::lround(std::atan2(dx, dz) * (128.0f / glm::pi<float>())) & 255);
+        }
+        ++dormantCursor;
     }
+    aiStats.dormantCount = dormant.size();
+}
 
-    // Think / move / shoot
-    for (auto& enemy : enemies) {
-        if (!enemy.active) continue;
+// Sorts the active boats into distance tiers and lists the ones to step this tick in
+// toStep, in index order. Boats that sit this tick out keep prev == current so they
+// render still.
+void EnemyManager::pickBoatsToStep(const glm::vec3& playerPosition) {
+    toStep.clear();
+    farBoats.clear();
+    flockGrid.Begin(enemies.Size());
+    size_t nearCount = 0, midCount = 0;
+    for (size_t i = 0; i < enemies.Size(); ++i) {
+        enemies.prevPosition[i] = enemies.Position(i);
+        enemies.prevFaceX[i] = enemies.faceX[i];
+        enemies.prevFaceZ[i] = enemies.faceZ[i];
+        if (!enemies.active[i]) continue;
+        flockGrid.Add(static_cast<uint32_t>(i), enemies.prevPosition[i]);
 
-        if (enemy.shootCooldown > 0.0f) enemy.shootCooldown -= dt;
+        const glm::vec3 d = enemies.Position(i) - playerPosition;
+        const float d2 = glm::dot(d, d);
+        if (d2 <= kNearAiRadius * kNearAiRadius) {
+            ++nearCount;
+            toStep.push_back(static_cast<uint32_t>(i));
+        } else if (d2 <= kMidAiRadius * kMidAiRadius) {
+            ++midCount;
+            if (thinkTick - enemies.lastThink[i] >= kMidAiInterval) toStep.push_back(static_cast<uint32_t>(i));
+        } else {
+            farBoats.push_back(static_cast<uint32_t>(i));
+        }
+    }
 
-        glm::vec3 dir = playerPosition - enemy.position;
-        const float dist = glm::length(dir);
-        const float minPlayerDistance = 5.0f;
+    // The next slice of far boats, wrapping around. Indices shift as boats despawn, so the
+    // rotation is approximate, but every far boat gets its turn within a few passes.
+    const size_t farTaken = std::min(kFarAiBudget, farBoats.size());
+    if (farTaken > 0) {
+        const size_t start = farCursor % farBoats.size();
+        for (size_t k = 0; k < farTaken; ++k) toStep.push_back(farBoats[(start + k) % farBoats.size()]);
+        farCursor = start + farTaken;
+        std::sort(toStep.begin(), toStep.end());
+    }
 
-        glm::vec3 oldPos = enemy.position;
-        if (dist > minPlayerDistance + 3.0f)      enemy.position += glm::normalize(dir) * enemy.speed * dt;
-        else if (dist < minPlayerDistance)        enemy.position -= glm::normalize(dir) * enemy.speed * 0.5f * dt;
+    flockGrid.Finalize();
 
-        if (mountainManager.checkCollision(enemy.position, 1.0f)) enemy.position = oldPos;
+    aiStats.nearCount = nearCount;
+    aiStats.midCount  = midCount;
+    aiStats.farCount  = farBoats.size();
+    aiStats.stepped   = toStep.size();
+    aiStats.steppedTotal += toStep.size();
+    ++aiStats.thinks;
+}
 
-        if (dist > 0.1f) enemy.rotation = atan2(dir.x, dir.z) * 180.0f / glm::pi<float>();
+void EnemyManager::Destroy(size_t i) {
+    if (!enemies.active[i]) return;
+    enemies.active[i] = 0;
+    ++destroyedPending;
+}
 
-        if (dist <= 25.0f && dist > minPlayerDistance && enemy.shootCooldown <= 0.0f) {
-            glm::vec3 muzzle = enemy.position + glm::vec3(sin(glm::radians(enemy.rotation)) * 2.0f, 0.0f, cos(glm::radians(enemy.rotation)) * 2.0f);
-            glm::vec3 vel    = glm::normalize(dir) * 8.0f;
-            projectileManager.AddProjectile(muzzle, vel, false);
-            enemy.shootCooldown = enemy.maxShootCooldown;
+void EnemyManager::RetireDestroyed() {
+    if (destroyedPending == 0) return;
+    removeBoats([&](size_t i) { return !enemies.active[i]; });
+    retired += destroyedPending;
+    destroyedPending = 0;
+}
+
+void EnemyManager::FloatBoats(float time, float dt) {
+    buoyancy.Float(BuoyancyArrays{ enemies.posX.data(), enemies.posZ.data(), enemies.faceX.data(), enemies.faceZ.data(),
+                                   enemies.heave.data(), enemies.pitch.data(), enemies.roll.data(),
+                                   enemies.heaveRate.data(), enemies.pitchRate.data(), enemies.rollRate.data(),
+                                   enemies.Size() },
+                   kEnemyBuoyancy, time, dt);
+}
+
+void EnemyManager::FlushShots(ProjectileManager& projectileManager) {
+    for (const FireRequest& f : fireMerged) projectileManager.AddBallistic(f.muzzle, f.velocity, false);
+}
+
+// Everything Think does per boat, for toStep[begin, end). Touches nothing outside those boats.
+void EnemyManager::stepRange(size_t begin, size_t end, const glm::vec3& playerPosition, float dt,
+                             const MountainManager& mountainManager, std::vector<FireRequest>& fired) {
+    const size_t n = end - begin;
+    for (size_t k = begin; k < end; ++k) {
+        const uint32_t i = toStep[k];
+        stepX[k] = enemies.posX[i];
+        stepY[k] = enemies.posY[i];
+        stepZ[k] = enemies.posZ[i];
+        stepArmed[k] = enemies.armed[i];
+        stepFaceX[k] = enemies.faceX[i];
+        stepFaceZ[k] = enemies.faceZ[i];
+        stepDt[k] = static_cast<float>(thinkTick - enemies.lastThink[i]) * dt;
+        enemies.lastThink[i] = thinkTick;
+    }
+
+    // Think / move: one kernel pass over the gathered boats, then one batched query tests
+    // all the moves against the mountains.
+    const EnemySteerArrays arrays{ stepX.data() + begin, stepY.data() + begin, stepZ.data() + begin,
+                                   stepArmed.data() + begin, stepFaceX.data() + begin, stepFaceZ.data() + begin,
+                                   stepDt.data() + begin, stepActive.data() + begin, fireNow.data() + begin, n };
+    const EnemySteerParams params{ playerPosition.x, playerPosition.y, playerPosition.z,
+                                   kEnemySpeed, kMinPlayerDistance, kApproachSlack, kFireRange };
+    SteerEnemies(arrays, params);
+
+    // Boats closing in trade the kernel's straight line for the flow field's route around
+    // the mountains, and boats swinging out after a shot move sideways instead. Flocking
+    // reads only the start-of-tick snapshot, so chunks never see each other's moves.
+    const FlockView flock{ enemies.prevPosition.data(), enemies.prevFaceX.data(), enemies.prevFaceZ.data() };
+    const float seekDistance = kMinPlayerDistance + kApproachSlack;
+    for (size_t k = begin; k < end; ++k) {
+        const uint32_t i = toStep[k];
+        const glm::vec3 from = enemies.Position(i);
+        const glm::vec3 toPlayer = playerPosition - from;
+        const float flat = std::sqrt(toPlayer.x * toPlayer.x + toPlayer.z * toPlayer.z);
+        glm::vec2 route;
+        if (enemies.strafe[i] != 0 && flat > 0.0f) {
+            const float side = static_cast<float>(enemies.strafe[i]) * kEnemySpeed * stepDt[k] / flat;
+            stepX[k] = from.x - toPlayer.z * side;
+            stepZ[k] = from.z + toPlayer.x * side;
+        } else if (glm::dot(toPlayer, toPlayer) > seekDistance * seekDistance && navField.Sample(from, route)) {
+            stepX[k] = from.x + route.x * kEnemySpeed * stepDt[k];
+            stepZ[k] = from.z + route.y * kEnemySpeed * stepDt[k];
         }
+        const glm::vec2 v = FlockSteer(flockGrid, flock, i, kFlock);
+        moveTo[k] = glm::vec3(stepX[k] + v.x * stepDt[k], stepY[k], stepZ[k] + v.y * stepDt[k]);
+    }
+    mountainManager.checkCollisionBatch(std::span<const glm::vec3>(moveTo.data() + begin, n),
+                                        std::span<const float>(&kBoatRadius, 1),
+                                        std::span<uint8_t>(moveBlocked.data() + begin, n));
+
+    // Scatter back, then shoot
+    for (size_t k = begin; k < end; ++k) {
+        const uint32_t i = toStep[k];
+        if (!moveBlocked[k]) enemies.SetPosition(i, moveTo[k]);
+        enemies.faceX[i] = stepFaceX[k];
+        enemies.faceZ[i] = stepFaceZ[k];
+        if (!fireNow[k]) continue;
+
+        const glm::vec3 muzzle = enemies.Position(i) + glm::vec3(enemies.faceX[i] * 2.0f, kMuzzleHeight + enemies.heave[i], enemies.faceZ[i] * 2.0f);
+        fired.push_back(FireRequest{ i, muzzle, glm::vec3(0.0f) });
+        enemies.armed[i] = 0;
     }
 }
 
-void EnemyManager::SpawnEnemy(const glm::vec3& playerPosition, MountainManager& mountainManager) {
-    std::random_device rd; std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angle(0.0f, 2.0f * glm::pi<float>());
-    std::uniform_real_distribution<float> radius(SPAWN_RADIUS_MIN, SPAWN_RADIUS_MAX);
+// Dart throwing over the spawn annulus with a grid for the spacing test. Candidates come
+// in rounds, each round is tested against the mountains in one batched query, and the
+// clear ones are accepted in draw order unless a boat in the grid or an earlier pick is
+// too close. Positions from the previous batch that were never released are dropped.
+void EnemyManager::sampleSpawnBatch(const glm::vec3& playerPosition, const MountainManager& mountainManager,
+                                    size_t count) {
+    pendingSpawns.clear();
+    nextSpawn = 0;
 
-    glm::vec3 pos;
-    bool ok = false;
-    int attempts = 0;
-    do {
-        const float a = angle(gen);
-        const float r = radius(gen);
-        pos = playerPosition + glm::vec3(cos(a) * r, -1.0f, sin(a) * r); 
-        ok = !mountainManager.checkCollision(pos, 1.0f);
-        if (ok) {
-            for (const auto& e : enemies) {
-                if (e.active && glm::length(pos - e.position) < 5.0f) { ok = false; break; }
-            }
+    // Only boats that could be within kSpawnSpacing of the annulus matter.
+    const float nearR = SPAWN_RADIUS_MIN - kSpawnSpacing, farR = SPAWN_RADIUS_MAX + kSpawnSpacing;
+    spawnGrid.Begin(enemies.Size() + count);
+    for (size_t i = 0; i < enemies.Size(); ++i) {
+        const glm::vec3 d = enemies.Position(i) - playerPosition;
+        const float d2 = d.x * d.x + d.z * d.z;
+        if (d2 >= nearR * nearR && d2 <= farR * farR) spawnGrid.Add(static_cast<uint32_t>(i), enemies.Position(i));
+    }
+    spawnGrid.Finalize();
+
+    float angles[kSpawnCandidates];
+    float radii[kSpawnCandidates];
+    glm::vec3 candidates[kSpawnCandidates];
+    uint8_t blocked[kSpawnCandidates];
+
+    const size_t maxTries = count * kSpawnTriesPerBoat;
+    for (size_t tried = 0; tried < maxTries && pendingSpawns.size() < count; tried += kSpawnCandidates) {
+        const size_t n = std::min(kSpawnCandidates, maxTries - tried);
+        rng->FillAngles(angles, n);
+        rng->FillRange(radii, n, SPAWN_RADIUS_MIN, SPAWN_RADIUS_MAX);
+        for (size_t i = 0; i < n; ++i) {
+            candidates[i] = playerPosition + glm::vec3(std::cos(angles[i]) * radii[i], -1.0f, std::sin(angles[i]) * radii[i]);
         }
-        attempts++;
-    } while (!ok && attempts < 50);
+        mountainManager.checkCollisionBatch(std::span<const glm::vec3>(candidates, n),
+                                            std::span<const float>(&kBoatRadius, 1), std::span<uint8_t>(blocked, n));
 
-    if (ok) enemies.emplace_back(pos);
+        for (size_t i = 0; i < n && pendingSpawns.size() < count; ++i) {
+            if (blocked[i]) continue;
+            bool clear = true;
+            spawnGrid.Query(candidates[i], kSpawnSpacing, [&](uint32_t, float) { clear = false; });
+            for (size_t k = 0; clear && k < pendingSpawns.size(); ++k) {
+                const glm::vec3 d = candidates[i] - pendingSpawns[k];
+                clear = d.x * d.x + d.z * d.z >= kSpawnSpacing * kSpawnSpacing;
+            }
+            if (clear) pendingSpawns.push_back(candidates[i]);
+        }
+    }
 }
@@ -0,0 +1,61 @@
+#include "Flocking.h"
+#include "SpatialHash.h"
+#include <cmath>
+
+namespace {
+
+struct FlockSums {
+    glm::vec2 away{ 0.0f };     // separation, weighted by closeness
+    glm::vec2 heading{ 0.0f };
+    glm::vec2 center{ 0.0f };
+    int       count = 0;
+
+    void Add(const FlockView& boats, uint32_t self, uint32_t other, float d2, const FlockParams& p) {
+        const glm::vec3& a = boats.position[self];
+        const glm::vec3& b = boats.position[other];
+        const glm::vec2 offset(a.x - b.x, a.z - b.z);
+        if (d2 < p.separationRadius * p.separationRadius && d2 > 0.0f) {
+            const float d = std::sqrt(d2);
+            away += offset * ((p.separationRadius - d) / (p.separationRadius * d));
+        }
+        heading += glm::vec2(boats.headingX[other], boats.headingZ[other]);
+        center  += glm::vec2(b.x, b.z);
+        ++count;
+    }
+
+    glm::vec2 Steer(const FlockView& boats, uint32_t self, const FlockParams& p) const {
+        if (count == 0) return glm::vec2(0.0f);
+        const float inv = 1.0f / static_cast<float>(count);
+        const glm::vec3& a = boats.position[self];
+        const glm::vec2 align = heading * inv - glm::vec2(boats.headingX[self], boats.headingZ[self]);
+        const glm::vec2 cohere = (center * inv - glm::vec2(a.x, a.z)) / p.radius;
+        glm::vec2 v = away * p.separationWeight + align * p.alignmentWeight + cohere * p.cohesionWeight;
+        const float len2 = glm::dot(v, v);
+        if (len2 > p.maxSpeed * p.maxSpeed) v *= p.maxSpeed / std::sqrt(len2);
+        return v;
+    }
+};
+
+} // namespace
+
+glm::vec2 FlockSteer(const SpatialHash& grid, const FlockView& boats, uint32_t self, const FlockParams& p) {
+    FlockSums sums;
+    // One extra slot since the boat finds itself.
+    grid.QueryUpTo(boats.position[self], p.radius, p.maxNeighbors + 1, [&](uint32_t id, float d2) {
+        if (id != self && sums.count < static_cast<int>(p.maxNeighbors)) sums.Add(boats, self, id, d2, p);
+    });
+    return sums.Steer(boats, self, p);
+}
+
+glm::vec2 FlockSteerBruteForce(const FlockView& boats, size_t count, uint32_t self, const FlockParams& p) {
+    FlockSums sums;
+    const glm::vec3& a = boats.position[self];
+    for (size_t j = 0; j < count; ++j) {
+        if (j == self) continue;
+        const float dx = boats.position[j].x - a.x;
+        const float dz = boats.position[j].z - a.z;
+        const float d2 = dx * dx + dz * dz;
+        if (d2 < p.radius * p.radius) sums.Add(boats, self, static_cast<uint32_t>(j), d2, p);
+    }
+    return sums.Steer(boats, self, p);
+}
@@ -4,19 +4,42 @@
 #include "EnemyManager.h"
 #include "ProjectileManager.h"
 #include "MountainManager.h"
+#include "ModelManager.h"
+#include "Ballistics.h"
+#include "Waves.h"
+#include "JobSystem.h"
+#include "TaskGraph.h"
 #include "UserInterface.h"
 #include "BoatSkinIds.h"
 #include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
 #include <iostream>
+#include <random>
 
 // callbacks
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 
+using SimClock = std::chrono::steady_clock;
+
+// Longest frame the accumulator will accept, and the most ticks run to catch up in one frame.
+// Anything beyond that is dropped so a stall slows the game down instead of spiralling.
+static constexpr double kMaxFrameSeconds  = 0.25;
+static constexpr int    kMaxTicksPerFrame = 8;
+
+// Projectile pool size per difficulty: every enemy in range firing each cooldown, with the
+// longest lifetime, plus headroom for the player. Shots beyond it are dropped.
+static constexpr size_t kProjectileCapacityEasy = 512;
+static constexpr size_t kProjectileCapacityHard = 1024;
+
 Game::Game(unsigned int width, unsigned int height)
     : window(nullptr), screenWidth(width), screenHeight(height),
-      state(MAIN_MENU), difficulty(EASY), gameTime(0.0f), score(0),
-      enemiesDestroyed(0), finalScore(0), waveTime(0.0f),
+      state(MAIN_MENU), difficulty(EASY), gameTime(0.0), score(0),
+      enemiesDestroyed(0), finalScore(0), waveTime(0.0),
       cameraYaw(0.0f), cameraPitch(0.0f), cameraDistance(15.0f), cameraHeight(8.0f),
       firstMouse(true), lastX(width / 2.0), lastY(height / 2.0), isFirstPerson(false),
       enableRainbowWater(false), enableCrazyPhysics(false), enablePartyMode(false),
@@ -28,11 +51,20 @@ Game::Game(unsigned int width, unsigned int height)
 }
 
 Game::~Game() {
+    finishRecording();
     glfwTerminate();
 }
 
+void Game::SetTickRate(int hz) {
+    tickRate = (hz <= 30) ? 30 : (hz >= 120 ? 120 : 60);
+    tickDt   = 1.0 / tickRate;
+}
+
 void Game::SetState(GameState s) {
     if (state == s) return;
+    // Back at the main menu the match is over, however the menus got there (the pause
+    // menu's settings page included), so its recording ends.
+    if (s == MAIN_MENU) finishRecording();
     state = s;
     if (!window) return;
     if (state == PLAYING) {
@@ -78,11 +110,8 @@ void Game::Init() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     graphics          = std::make_unique<Graphics>();
-    player            = std::make_unique<Player>();
-    enemyManager      = std::make_unique<EnemyManager>();
-    projectileManager = std::make_unique<ProjectileManager>();
-    mountainManager   = std::make_unique<MountainManager>();
     ui                = std::make_unique<UserInterface>();
+    initSimulation();
 
     graphics->Init();
     ui->Init();
@@ -90,19 +119,223 @@ void Game::Init() {
     std::cout << "Game initialized.\n";
 }
 
-void Game::ProcessInput(float dt) {
+void Game::initSimulation() {
+    jobs              = std::make_unique<JobSystem>(threadCount);
+    player            = std::make_unique<Player>();
+    enemyManager      = std::make_unique<EnemyManager>();
+    enemyManager->SetJobSystem(jobs.get());
+    projectileManager = std::make_unique<ProjectileManager>();
+    mountainManager   = std::make_unique<MountainManager>();
+    boatHulls         = std::make_unique<ModelManager>();
+    boatHulls->LoadBoatHulls();
+    buildUpdateGraph();
+}
+
+// What the update tasks share. A task waits for every earlier task whose declared
+// resources clash with its own; the rest run concurrently.
+enum UpdateResource : TaskGraph::Resources {
+    RES_PLAYER_TRANSFORM = 1u << 0,
+    RES_PLAYER_HEALTH    = 1u << 1,
+    RES_PROJECTILES      = 1u << 2,
+    RES_ENEMIES          = 1u << 3,
+    RES_MOUNTAINS        = 1u << 4,
+    RES_SHOT_GRID        = 1u << 5,
+    RES_SCORE            = 1u << 6,
+    RES_BOAT_POSE        = 1u << 7, // heave, pitch and roll of the player and every enemy
+};
+
+// One tick's phases, declared in the order a single thread would run them. With these
+// declarations, projectile integration and the shot broadphase overlap enemy AI, and
+// mountain recycling overlaps projectile integration once the AI is done with the mountains.
+void Game::buildUpdateGraph() {
+    updateGraph = std::make_unique<TaskGraph>();
+    taskPhase.clear();
+    auto add = [&](const char* name, TaskGraph::Resources reads, TaskGraph::Resources writes,
+                   double PhaseTimings::* phase, std::function<void()> fn) {
+        updateGraph->Add(name, reads, writes, std::move(fn));
+        taskPhase.push_back(phase);
+    };
+
+    // Player input can fire a shot, hence the projectile write.
+    add("player", RES_MOUNTAINS, RES_PLAYER_TRANSFORM | RES_PLAYER_HEALTH | RES_PROJECTILES, &PhaseTimings::player, [this] {
+        InputState tickInput;
+        tickInput.down = tickCommand.buttons;
+        player->SnapshotTransform();
+        if (tickCommand.yawMilli != 0) player->AdjustRotation(tickCommand.yawMilli * 0.001f);
+        player->SetPhysicsMode(enableCrazyPhysics);
+        player->SetBoatSkin(boatSkinIndex);
+        player->ProcessGameInput(tickInput, tickSeconds, *projectileManager, *mountainManager);
+        if (boatSkinIndex == BoatSkinId::GOING_MERRY) {
+            player->AlignToWater(-1.0f);
+        }
+        player->Update(tickSeconds);
+    });
+    add("projectile schedule", RES_MOUNTAINS, RES_PROJECTILES, &PhaseTimings::projectiles, [this] {
+        projectileManager->Schedule(tickSeconds, *mountainManager);
+    });
+    add("projectile integrate", 0, RES_PROJECTILES, &PhaseTimings::projectiles, [this] {
+        projectileManager->Integrate(tickSeconds);
+    });
+    add("enemy AI", RES_PLAYER_TRANSFORM | RES_MOUNTAINS, RES_ENEMIES, &PhaseTimings::enemies, [this] {
+        enemyManager->Think(tickSeconds, player->GetPosition(), *mountainManager);
+    });
+    add("shot broadphase", RES_PROJECTILES, RES_SHOT_GRID, &PhaseTimings::collisions, [this] {
+        buildShotGrid();
+    });
+    // Enemy shots are appended, so the player-shot indices in the grid stay valid.
+    add("enemy fire", RES_ENEMIES, RES_PROJECTILES, &PhaseTimings::enemies, [this] {
+        enemyManager->FlushShots(*projectileManager);
+    });
+    // Only the pose columns of the enemy store are written, so this overlaps enemy fire.
+    add("buoyancy", RES_PLAYER_TRANSFORM | RES_ENEMIES, RES_BOAT_POSE, &PhaseTimings::buoyancy, [this] {
+        const float time = static_cast<float>(waveTime);
+        enemyManager->FloatBoats(time, tickSeconds);
+        player->Float(time, tickSeconds);
+    });
+    add("mountains", RES_PLAYER_TRANSFORM, RES_MOUNTAINS, &PhaseTimings::mountains, [this] {
+        mountainManager->Update(tickSeconds, player->GetPosition());
+    });
+    add("collisions", RES_SHOT_GRID | RES_PLAYER_TRANSFORM | RES_BOAT_POSE,
+        RES_ENEMIES | RES_PROJECTILES | RES_PLAYER_HEALTH | RES_SCORE, &PhaseTimings::collisions, [this] {
+        checkCollisions();
+    });
+}
+
+// Steps the simulation as fast as possible with no window, GL context, Graphics or UI.
+// Without a replay the player sits idle, and a new match starts whenever it dies so the
+// load stays steady. With a replay the recorded match runs once, to completion.
+int Game::RunHeadless(const LaunchOptions& options) {
+    initSimulation();
+    player->SetVerbose(false);
+
+    long long maxTicks = options.ticks;
+    if (!options.replayPath.empty()) {
+        if (!StartReplay(options.replayPath)) return 1;
+        maxTicks = static_cast<long long>(replay.GetDigest().ticks);
+    } else {
+        difficulty = options.difficulty;
+        SetTickRate(options.tickRate);
+        startNewGame(options.seed);
+    }
+
+    const float dt = static_cast<float>(tickDt);
+    int matches = 1;
+    long long tick = 0;
+    const SimClock::time_point start = SimClock::now();
+    for (; tick < maxTicks; ++tick) {
+        Update(dt);
+        if (state == GAME_OVER) {
+            if (IsReplaying()) { ++tick; break; }
+            startNewGame(options.seed + matches);
+            ++matches;
+        }
+    }
+    const double wallSeconds = std::chrono::duration<double>(SimClock::now() - start).count();
+
+    printHeadlessReport(tick, wallSeconds, matches);
+    return 0;
+}
+
+void Game::printHeadlessReport(long long ticks, double wallSeconds, int matches) const {
+    const EnemyStore& enemies = enemyManager->GetEnemies();
+    const EnemyAiStats& ai = enemyManager->GetAiStats();
+    const BehaviorScheduler& behaviors = enemyManager->GetBehaviors();
+    const NavFieldStats& nav = enemyManager->GetNavField().GetStats();
+
+    const ProjectileStore& projectiles = projectileManager->GetProjectiles();
+    const TimerWheelStats& shotTimers = projectileManager->GetTimers().GetStats();
+    const double perTick = (ticks > 0) ? 1e6 / static_cast<double>(ticks) : 0.0;
+    std::cout << std::fixed << std::setprecision(2)
+              << "Headless run: " << ticks << " ticks in " << wallSeconds << " s ("
+              << (wallSeconds > 0.0 ? ticks / wallSeconds : 0.0) << " ticks/s), "
+              << matches << " match(es) at " << tickRate << " Hz on " << jobs->ThreadCount() << " thread(s)\n"
+              << "  enemies:     " << enemies.Size() << " live (" << enemyManager->RetiredCount() << " sunk and retired)\n"
+              << "  AI tiers:    near " << ai.nearCount << ", mid " << ai.midCount << ", far " << ai.farCount
+              << " (" << (ai.thinks > 0 ? static_cast<double>(ai.steppedTotal) / ai.thinks : 0.0) << " stepped per tick)\n"
+              << "  dormant:     " << ai.dormantCount << " parked (" << ai.spawned << " spawned, " << ai.slept
+              << " put to sleep, " << ai.woken << " woken, " << ai.forgotten << " forgotten this match)\n"
+              << "  gunnery:     " << ai.shellsFired << " shells fired, " << ai.shellsOutOfRange
+              << " with the player out of reach this match\n"
+              << "  sight lines: " << ai.sightLines << " tested, " << ai.sightBlocked << " blocked by mountains ("
+              << (ai.thinks > 0 ? ai.sightSeconds * 1e6 / ai.thinks : 0.0) << " us per tick)\n"
+              << "  behaviors:   " << behaviors.Live() << " running, " << behaviors.WaitingForSignal()
+              << " waiting for a signal ("
+              << (ticks > 0 ? static_cast<double>(behaviors.Resumes()) / ticks : 0.0)
+              << " resumes per tick)\n"
+              << "  navigation:  " << nav.solves << " flow-field solves (" << nav.fullRebuilds << " full rebuilds, "
+              << nav.cellsRasterized << " cells rasterized)\n"
+              << "  projectiles: " << projectiles.Size() << " (high-water " << projectiles.HighWater()
+              << " of " << projectiles.Capacity() << ", " << projectiles.Dropped() << " dropped)\n"
+              << "  shot timers: " << projectileManager->GetTimers().Size() << " pending, " << shotTimers.fired
+              << " fired, " << shotTimers.cascaded << " moved down a level this match\n"
+              << "  hulls:       " << hullTests << " segment tests, " << hullMisses
+              << " inside a boat's bounds but clear of its hull ("
+              << (boatHulls->EnemyHull() ? boatHulls->EnemyHull()->TriangleCount() : 0) << " enemy triangles, "
+              << (boatHulls->PlayerHull(boatSkinIndex) ? boatHulls->PlayerHull(boatSkinIndex)->TriangleCount() : 0)
+              << " player)\n"
+              << "  buoyancy:    " << (enemyManager->WaveSampleCount() + player->WaveSampleCount())
+              << " wave heights sampled (" << WaveSamplePath() << " path)\n"
+              << "  mountains:   " << mountainManager->GetMountains().size() << "\n"
+              << "  score:       " << score << ", enemies destroyed: " << enemiesDestroyed << "\n"
+              << std::setprecision(3)
+              << "Per-tick phase timings (us):\n"
+              << "  player:      " << phaseTimings.player      * perTick << "\n"
+              << "  projectiles: " << phaseTimings.projectiles * perTick << "\n"
+              << "  enemies:     " << phaseTimings.enemies     * perTick << "\n"
+              << "  mountains:   " << phaseTimings.mountains   * perTick << "\n"
+              << "  buoyancy:    " << phaseTimings.buoyancy    * perTick << "\n"
+              << "  collisions:  " << phaseTimings.collisions  * perTick << "\n"
+              << "  frame:       " << phaseTimings.frame        * perTick
+              << " (critical path " << phaseTimings.criticalPath * perTick << ")\n";
+}
+
+InputState Game::PollInput() {
+    uint32_t down = 0;
+    if (window) {
+        struct KeyBinding { int key; uint32_t button; };
+        static const KeyBinding kBindings[] = {
+            { GLFW_KEY_W,           BTN_FORWARD },
+            { GLFW_KEY_S,           BTN_BACK },
+            { GLFW_KEY_A,           BTN_TURN_LEFT },
+            { GLFW_KEY_D,           BTN_TURN_RIGHT },
+            { GLFW_KEY_LEFT_SHIFT,  BTN_BOOST },
+            { GLFW_KEY_RIGHT_SHIFT, BTN_BOOST },
+            { GLFW_KEY_SPACE,       BTN_FIRE },
+            { GLFW_KEY_UP,          BTN_ARROW_UP },
+            { GLFW_KEY_DOWN,        BTN_ARROW_DOWN },
+            { GLFW_KEY_LEFT,        BTN_ARROW_LEFT },
+            { GLFW_KEY_RIGHT,       BTN_ARROW_RIGHT },
+            { GLFW_KEY_ENTER,       BTN_CONFIRM },
+            { GLFW_KEY_ESCAPE,      BTN_CANCEL },
+            { GLFW_KEY_1,           BTN_VIEW_FIRST },
+            { GLFW_KEY_2,           BTN_VIEW_THIRD },
+            { GLFW_KEY_C,           BTN_DEBUG_MOUNTAINS },
+            { GLFW_KEY_P,           BTN_PAUSE },
+        };
+        for (const auto& b : kBindings) {
+            if (glfwGetKey(window, b.key) == GLFW_PRESS) down |= b.button;
+        }
+    }
+
+    InputState input = lastInput.Next(down, pendingMouseX, pendingMouseY);
+    pendingMouseX = 0.0f;
+    pendingMouseY = 0.0f;
+    return input;
+}
+
+void Game::ProcessInput(const InputState& input) {
+    lastInput = input;
+
     if (state == PLAYING) {
-        static bool fpTogglePrev = false;
-        static bool tpTogglePrev = false;
-        bool key1Down = glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS;
-        bool key2Down = glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS;
+        const bool key1Down = input.IsDown(BTN_VIEW_FIRST);
+        const bool key2Down = input.IsDown(BTN_VIEW_THIRD);
 
         if (boatSkinIndex == BoatSkinId::GOING_MERRY) {
-            if (key1Down && !fpTogglePrev) {
+            if (input.WasPressed(BTN_VIEW_FIRST)) {
                 shipCamera.mode = Camera::FIRST_PERSON;
                 shipCamera.SetPitch(0.0f);
             }
-            if (key2Down && !tpTogglePrev) {
+            if (input.WasPressed(BTN_VIEW_THIRD)) {
                 shipCamera.mode = Camera::THIRD_PERSON;
                 shipCamera.SetYaw(player->GetRotation());
             }
@@ -118,45 +351,70 @@ void Game::ProcessInput(float dt) {
             }
         }
 
-        fpTogglePrev = key1Down;
-        tpTogglePrev = key2Down;
-
-        static bool cPrev = false;
-        bool cNow = glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS;
-        if (cNow && !cPrev) enableDebugMountains = !enableDebugMountains;
-        cPrev = cNow;
+        if (input.WasPressed(BTN_DEBUG_MOUNTAINS)) enableDebugMountains = !enableDebugMountains;
 
-        player->SetPhysicsMode(enableCrazyPhysics);
-        player->SetBoatSkin(boatSkinIndex);
-        player->ProcessGameInput(window, dt, *projectileManager, *mountainManager);
-
-        if (boatSkinIndex == BoatSkinId::GOING_MERRY) {
-            player->AlignToWater(-1.0f);
-        }
+        applyMouseLook(input);
 
-        if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS) {
+        if (input.IsDown(BTN_PAUSE)) {
             SetState(PAUSED);
         }
     } else {
-        ProcessMenuInput(dt);
+        ProcessMenuInput(input);
     }
 }
 
-void Game::Update(float dt) {
-    if (state == PLAYING) {
-        gameTime += dt;
-        waveTime += dt;
+// Runs as many fixed ticks as the elapsed frame time covers and returns how many ran.
+int Game::Advance(double frameSeconds) {
+    if (state != PLAYING) {
+        tickAccumulator = 0.0;
+        renderAlpha = 1.0f;
+        return 0;
+    }
 
-        player->Update(dt);
-        projectileManager->Update(dt, *mountainManager);
-        enemyManager->Update(dt, player->GetPosition(), *projectileManager, *mountainManager);
-        mountainManager->Update(dt, player->GetPosition());
+    tickAccumulator += std::min(std::max(frameSeconds, 0.0), kMaxFrameSeconds);
 
-        checkCollisions();
+    int ticks = 0;
+    while (tickAccumulator >= tickDt && ticks < kMaxTicksPerFrame && state == PLAYING) {
+        Update(static_cast<float>(tickDt));
+        tickAccumulator -= tickDt;
+        ++ticks;
+    }
+    if (tickAccumulator >= tickDt) tickAccumulator = std::fmod(tickAccumulator, tickDt);
+
+    renderAlpha = static_cast<float>(tickAccumulator / tickDt);
+    return ticks;
+}
+
+// One simulation tick. Player movement reads the most recent input sample.
+void Game::Update(float dt) {
+    if (state == PLAYING) {
+        ++simTick;
+        gameTime = simTick * tickDt;
+        waveTime = gameTime;
+
+        const TickCommand cmd = nextTickCommand();
+        if (state != PLAYING) return;
+        recorder.Record(cmd);
+
+        tickCommand = cmd;
+        tickSeconds = dt;
+        updateGraph->Run(*jobs);
+        for (size_t t = 0; t < updateGraph->Size(); ++t) {
+            phaseTimings.*taskPhase[t] += updateGraph->TaskSeconds(static_cast<int>(t));
+        }
+        phaseTimings.frame        += updateGraph->WallSeconds();
+        phaseTimings.criticalPath += updateGraph->CriticalPathSeconds();
+        if (dumpTaskGraph) {
+            std::cout << "tick " << simTick << ": ";
+            updateGraph->DumpCriticalPath(std::cout);
+        }
 
         if (player->GetHealth() <= 0) {
             triggerGameOver();
         }
+        if (IsReplaying() && replay.TicksPlayed() >= replay.GetDigest().ticks) {
+            finishReplay();
+        }
     }
 }
 
@@ -165,8 +423,10 @@ void Game::Render() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     if (state == PLAYING || state == PAUSED) {
+        const float alpha = (state == PLAYING) ? renderAlpha : 1.0f;
         graphics->Render(*player, *enemyManager, *projectileManager, *mountainManager,
-                         waveTime, cameraYaw, cameraPitch, cameraDistance, cameraHeight,
+                         static_cast<float>(waveTime + (alpha - 1.0f) * tickDt), alpha,
+                         cameraYaw, cameraPitch, cameraDistance, cameraHeight,
                          isFirstPerson,
                          enableRainbowWater,
                          enablePartyMode,
@@ -175,26 +435,33 @@ void Game::Render() {
                          shipCamera,
                          player->GetShipFront());
 
-        ui->RenderHUD(player->GetHealth(), player->GetMaxHealth(), score, gameTime, enemiesDestroyed, difficulty);
+        ui->RenderHUD(player->GetHealth(), player->GetMaxHealth(), score, static_cast<float>(gameTime), enemiesDestroyed, difficulty);
         if (state == PAUSED) ui->RenderPauseScreen(selectedPauseItem);
     } else if (state == GAME_OVER) {
-        ui->RenderGameOverScreen(finalScore, enemiesDestroyed, gameTime, difficulty);
+        ui->RenderGameOverScreen(finalScore, enemiesDestroyed, static_cast<float>(gameTime), difficulty);
     } else {
         ui->RenderMenu(state, selectedMenuItem, selectedDifficultyItem, selectedSettingsItem,
                        enableRainbowWater, enableCrazyPhysics, enablePartyMode, boatSkinIndex);
     }
 }
 
-void Game::startNewGame() {
+void Game::startNewGame(uint32_t seed) {
+    finishRecording();
+    matchSeed = seed;
     SetState(PLAYING);
-    player->Reset();
-    enemyManager->Init(difficulty);
-    projectileManager->Clear();
-    mountainManager->Init();
-    gameTime = 0.0f;
+    rngService.Seed(seed);
+    player->Reset(static_cast<float>(tickDt));
+    enemyManager->Init(difficulty, rngService.Stream(RngStream::ENEMIES));
+    projectileManager->Init(difficulty == EASY ? kProjectileCapacityEasy : kProjectileCapacityHard);
+    mountainManager->Init(rngService.Stream(RngStream::MOUNTAINS));
+    gameTime = 0.0;
+    simTick = 0;
+    tickAccumulator = 0.0;
+    renderAlpha = 1.0f;
+    pendingYaw = 0.0f;
     score = 0;
     enemiesDestroyed = 0;
-    waveTime = 0.0f;
+    waveTime = 0.0;
     finalScore = 0;
     firstMouse = true;
     isFirstPerson = false;
@@ -203,76 +470,232 @@ void Game::startNewGame() {
     shipCamera.SetPitch(-15.0f);
     cameraYaw = 0.0f;
     cameraPitch = 0.0f;
+
+    if (!recordPath.empty() && !IsReplaying()) {
+        ReplayHeader header;
+        header.seed         = seed;
+        header.difficulty   = static_cast<uint8_t>(difficulty);
+        header.boatSkin     = static_cast<uint8_t>(boatSkinIndex);
+        header.crazyPhysics = enableCrazyPhysics ? 1 : 0;
+        header.tickRate     = static_cast<uint16_t>(tickRate);
+        recorder.Begin(header);
+    }
 }
 
 void Game::triggerGameOver() {
     SetState(GAME_OVER);
     finalScore = score;
+    finishRecording();
 }
 
+bool Game::StartReplay(const std::string& path) {
+    if (!replay.Load(path)) return false;
+
+    const ReplayHeader& h = replay.GetHeader();
+    difficulty         = (h.difficulty == HARD) ? HARD : EASY;
+    boatSkinIndex      = h.boatSkin % BoatSkinId::COUNT;
+    enableCrazyPhysics = h.crazyPhysics != 0;
+    SetTickRate(h.tickRate);
+    startNewGame(h.seed);
+    std::cout << "Replaying " << path << ": " << replay.GetDigest().ticks << " ticks, seed " << h.seed << "\n";
+    return true;
+}
+
+// The input for the next tick: from the replay when one is loaded, otherwise the latest
+// live sample plus whatever mouse-look yaw has accumulated (quantized to 1/1000 degree).
+TickCommand Game::nextTickCommand() {
+    TickCommand cmd;
+    if (IsReplaying()) {
+        if (!replay.Next(cmd)) finishReplay();
+        return cmd;
+    }
+
+    const uint32_t kSimButtons = BTN_FORWARD | BTN_BACK | BTN_TURN_LEFT | BTN_TURN_RIGHT | BTN_BOOST | BTN_FIRE;
+    cmd.buttons  = lastInput.down & kSimButtons;
+    cmd.yawMilli = static_cast<int32_t>(std::lround(pendingYaw * 1000.0f));
+    pendingYaw  -= cmd.yawMilli * 0.001f;
+    return cmd;
+}
+
+void Game::finishRecording() {
+    if (!recorder.IsRecording()) return;
+
+    ReplayDigest digest;
+    digest.ticks            = recorder.TickCount();
+    digest.score            = score;
+    digest.enemiesDestroyed = enemiesDestroyed;
+    digest.health           = player ? player->GetHealth() : 0;
+    recorder.Save(recordPath, digest);
+}
+
+void Game::finishReplay() {
+    ReplayDigest reached;
+    reached.ticks            = replay.TicksPlayed();
+    reached.score            = score;
+    reached.enemiesDestroyed = enemiesDestroyed;
+    reached.health           = player->GetHealth();
+
+    const ReplayDigest& expected = replay.GetDigest();
+    if (reached == expected) {
+        std::cout << "Replay finished: matches recording (score " << score << ", health " << reached.health << ")\n";
+    } else {
+        std::cout << "Replay finished: DIVERGED from recording (score " << score << " vs " << expected.score
+                  << ", health " << reached.health << " vs " << expected.health
+                  << ", ticks " << reached.ticks << " vs " << expected.ticks << ")\n";
+    }
+    if (state != GAME_OVER) triggerGameOver();
+}
+
+// Player shots only; enemy shots are tested against the one player by the projectile
+// manager. Positions are worked out here once and kept for checkCollisions.
+void Game::buildShotGrid() {
+    const ProjectileStore& projs = projectileManager->GetProjectiles();
+    shotGrid.Begin(projs.Size());
+    shotPositions.resize(projs.Size());
+    shotPrevPositions.resize(projs.Size());
+    shotStep = 0.0f;
+    for (size_t i = 0; i < projs.Size(); ++i) {
+        if (!projs.playerOwned[i]) continue;
+        shotPositions[i] = projectileManager->Position(i);
+        shotPrevPositions[i] = projectileManager->PreviousPosition(i);
+        shotStep = std::max(shotStep, glm::distance(shotPositions[i], shotPrevPositions[i]));
+        shotGrid.Add(static_cast<uint32_t>(i), shotPositions[i]);
+    }
+    shotGrid.Finalize();
+}
+
+// Two stages per boat: each shot's path over the last tick against a sphere holding the
+// boat's hull, then for the shots inside, that segment against the hull's BVH in model
+// space. Without a hull (model file missing) the sphere test alone decides, with the old
+// fixed radii.
 void Game::checkCollisions() {
-    auto& projs = projectileManager->GetProjectiles();
-    auto& enemies = enemyManager->GetEnemies();
-
-    for (auto it = projs.begin(); it != projs.end();) {
-        bool removed = false;
-        if (it->isPlayerOwned) {
-            for (auto& e : enemies) {
-                if (e.active && glm::length(it->position - e.position) < 2.0f) {
-                    e.active = false;
-                    score += 100;
-                    enemiesDestroyed++;
-                    it = projs.erase(it);
-                    removed = true;
-                    break;
+    static constexpr float kEnemyHitRadius  = 2.0f;
+    static constexpr float kPlayerHitRadius = 1.5f;
+
+    const EnemyStore& enemies = enemyManager->GetEnemies();
+    const glm::vec3 boatScale(ModelManager::kBoatScale);
+
+    // Every (shot, enemy) pair within reach. The grid is XZ only, so keep the full 3D test.
+    const MeshBvh* enemyHull = boatHulls->EnemyHull();
+    const float enemyRadius = enemyHull
+        ? ModelManager::HullRadius(*enemyHull, boatHulls->EnemyHullTransform(glm::vec3(0.0f), 0.0f, boatScale))
+        : kEnemyHitRadius;
+    shotHits.clear();
+    if (shotGrid.Size() != 0) {
+        for (size_t e = 0; e < enemies.Size(); ++e) {
+            if (!enemies.active[e]) continue;
+            glm::vec3 enemyPos = enemies.Position(e);
+            if (enemyHull) enemyPos.y = kSeaLevel + ModelManager::kEnemyWaterline + enemies.heave[e];
+            shotCandidates.clear();
+            shotGrid.Query(enemyPos, enemyRadius + shotStep, [&](uint32_t id, float) {
+                if (SegmentDistance2(shotPrevPositions[id], shotPositions[id], enemyPos) < enemyRadius * enemyRadius)
+                    shotCandidates.push_back(id);
+            });
+            if (shotCandidates.empty()) continue;
+            glm::mat4 toModel(1.0f);
+            if (enemyHull)
+                toModel = glm::inverse(boatHulls->EnemyHullTransform(enemyPos, enemies.RotationDeg(e), boatScale,
+                                                                     enemies.pitch[e], enemies.roll[e]));
+            for (uint32_t id : shotCandidates) {
+                if (enemyHull) {
+                    ++hullTests;
+                    const glm::vec3 a(toModel * glm::vec4(shotPrevPositions[id], 1.0f));
+                    const glm::vec3 b(toModel * glm::vec4(shotPositions[id], 1.0f));
+                    if (!enemyHull->SegmentHits(a, b)) { ++hullMisses; continue; }
                 }
+                shotHits.emplace_back(id, static_cast<uint32_t>(e));
             }
-        } else {
-            if (glm::length(it->position - player->GetPosition()) < 1.5f) {
-                player->TakeDamage(20);
-                it = projs.erase(it);
-                removed = true;
+        }
+    }
+    // Resolve in shot order, each shot taking its lowest-index enemy still afloat: the same
+    // outcome as walking the shots and scanning the enemies in order.
+    std::sort(shotHits.begin(), shotHits.end());
+    spentProjectiles.clear();
+    for (const auto& [shot, enemy] : shotHits) {
+        if (!spentProjectiles.empty() && spentProjectiles.back() == shot) continue;
+        if (!enemies.active[enemy]) continue;
+        enemyManager->Destroy(enemy);
+        score += 100;
+        enemiesDestroyed++;
+        spentProjectiles.push_back(shot);
+    }
+
+    // The player's hull sits where Graphics draws the boat, riding the same waves.
+    const MeshBvh* playerHull = boatHulls->PlayerHull(boatSkinIndex);
+    glm::vec3 playerPos = player->GetPosition();
+    float playerRadius = kPlayerHitRadius;
+    glm::mat4 playerToModel(1.0f);
+    if (playerHull) {
+        if (boatSkinIndex != BoatSkinId::GOING_MERRY)
+            playerPos.y = kSeaLevel + ModelManager::kPlayerWaterline[boatSkinIndex % BoatSkinId::COUNT];
+        playerPos.y += player->GetHeave();
+        const glm::mat4 toWorld = boatHulls->PlayerHullTransform(boatSkinIndex, playerPos, player->GetRotation(), boatScale,
+                                                                 player->GetPitch(), player->GetRoll());
+        playerRadius = ModelManager::HullRadius(*playerHull, toWorld);
+        playerToModel = glm::inverse(toWorld);
+    }
+    projectileManager->CollectHitsOnTarget(playerPos, playerRadius, player->GetTopSpeed(), playerHits);
+    for (uint32_t shot : playerHits) {
+        if (playerHull) {
+            ++hullTests;
+            const glm::vec3 a(playerToModel * glm::vec4(projectileManager->PreviousPosition(shot), 1.0f));
+            const glm::vec3 b(playerToModel * glm::vec4(projectileManager->Position(shot), 1.0f));
+            if (!playerHull->SegmentHits(a, b)) {
+                ++hullMisses;
+                projectileManager->CheckAgainNextTick(shot);
+                continue;
             }
         }
-        if (!removed) ++it;
+        player->TakeDamage(20);
+        spentProjectiles.push_back(shot);
     }
+
+    // Highest index first, so each swap-remove only moves a projectile that is staying.
+    std::sort(spentProjectiles.begin(), spentProjectiles.end());
+    for (size_t k = spentProjectiles.size(); k-- > 0;) projectileManager->Remove(spentProjectiles[k]);
+    enemyManager->RetireDestroyed();
 }
 
-void Game::ProcessMenuInput(float) {
-    static bool upPressed=false, downPressed=false, leftPressed=false, rightPressed=false, enterPressed=false, escPressed=false;
+void Game::ProcessMenuInput(const InputState& input) {
+    const uint32_t upKeys    = BTN_ARROW_UP    | BTN_FORWARD;
+    const uint32_t downKeys  = BTN_ARROW_DOWN  | BTN_BACK;
+    const uint32_t leftKeys  = BTN_ARROW_LEFT  | BTN_TURN_LEFT;
+    const uint32_t rightKeys = BTN_ARROW_RIGHT | BTN_TURN_RIGHT;
+    const uint32_t enterKeys = BTN_CONFIRM     | BTN_FIRE;
 
-    bool up    = glfwGetKey(window, GLFW_KEY_UP)==GLFW_PRESS   || glfwGetKey(window, GLFW_KEY_W)==GLFW_PRESS;
-    bool down  = glfwGetKey(window, GLFW_KEY_DOWN)==GLFW_PRESS || glfwGetKey(window, GLFW_KEY_S)==GLFW_PRESS;
-    bool left  = glfwGetKey(window, GLFW_KEY_LEFT)==GLFW_PRESS || glfwGetKey(window, GLFW_KEY_A)==GLFW_PRESS;
-    bool right = glfwGetKey(window, GLFW_KEY_RIGHT)==GLFW_PRESS|| glfwGetKey(window, GLFW_KEY_D)==GLFW_PRESS;
-    bool enter = glfwGetKey(window, GLFW_KEY_ENTER)==GLFW_PRESS|| glfwGetKey(window, GLFW_KEY_SPACE)==GLFW_PRESS;
-    bool esc   = glfwGetKey(window, GLFW_KEY_ESCAPE)==GLFW_PRESS;
+    const bool up    = input.WasPressed(upKeys);
+    const bool down  = input.WasPressed(downKeys);
+    const bool left  = input.WasPressed(leftKeys);
+    const bool right = input.WasPressed(rightKeys);
+    const bool enter = input.WasPressed(enterKeys);
+    const bool esc   = input.WasPressed(BTN_CANCEL);
 
     switch (state) {
         case MAIN_MENU:
-            if (up && !upPressed)   selectedMenuItem = (selectedMenuItem - 1 + 3) % 3;
-            if (down && !downPressed) selectedMenuItem = (selectedMenuItem + 1) % 3;
-            if (enter && !enterPressed) {
+            if (up)   selectedMenuItem = (selectedMenuItem - 1 + 3) % 3;
+            if (down) selectedMenuItem = (selectedMenuItem + 1) % 3;
+            if (enter) {
                 if (selectedMenuItem == 0) SetState(DIFFICULTY_MENU);
                 else if (selectedMenuItem == 1) SetState(SETTINGS_MENU);
-                else if (selectedMenuItem == 2) glfwSetWindowShouldClose(window, true);
+                else if (selectedMenuItem == 2 && window) glfwSetWindowShouldClose(window, true);
             }
             break;
         case DIFFICULTY_MENU:
-            if (up && !upPressed)   selectedDifficultyItem = (selectedDifficultyItem - 1 + 2) % 2;
-            if (down && !downPressed) selectedDifficultyItem = (selectedDifficultyItem + 1) % 2;
-            if (enter && !enterPressed) {
+            if (up)   selectedDifficultyItem = (selectedDifficultyItem - 1 + 2) % 2;
+            if (down) selectedDifficultyItem = (selectedDifficultyItem + 1) % 2;
+            if (enter) {
                 difficulty = (selectedDifficultyItem == 0) ? EASY : HARD;
-                startNewGame();
+                replay.Unload();
+                startNewGame(std::random_device{}());
             }
-            if (esc && !escPressed) SetState(MAIN_MENU);
+            if (esc) SetState(MAIN_MENU);
             break;
         case SETTINGS_MENU: {
             const int items = 4; // Rainbow Water, Crazy Physics, Party Mode, Boat Skin
-            if (up && !upPressed)   selectedSettingsItem = (selectedSettingsItem - 1 + items) % items;
-            if (down && !downPressed) selectedSettingsItem = (selectedSettingsItem + 1) % items;
+            if (up)   selectedSettingsItem = (selectedSettingsItem - 1 + items) % items;
+            if (down) selectedSettingsItem = (selectedSettingsItem + 1) % items;
 
-            if (left && !leftPressed) {
+            if (left) {
                 switch (selectedSettingsItem) {
                     case 0: enableRainbowWater = !enableRainbowWater; break;
                     case 1: enableCrazyPhysics = !enableCrazyPhysics; break;
@@ -280,7 +703,7 @@ void Game::ProcessMenuInput(float) {
                     case 3: boatSkinIndex      = (boatSkinIndex - 1 + BoatSkinId::COUNT) % BoatSkinId::COUNT; break;
                 }
             }
-            if (right && !rightPressed) {
+            if (right) {
                 switch (selectedSettingsItem) {
                     case 0: enableRainbowWater = !enableRainbowWater; break;
                     case 1: enableCrazyPhysics = !enableCrazyPhysics; break;
@@ -288,25 +711,23 @@ void Game::ProcessMenuInput(float) {
                     case 3: boatSkinIndex      = (boatSkinIndex + 1) % BoatSkinId::COUNT; break;
                 }
             }
-            if (esc && !escPressed) SetState(MAIN_MENU);
+            if (esc) SetState(MAIN_MENU);
         } break;
         case PAUSED:
-            if (up && !upPressed)   selectedPauseItem = (selectedPauseItem - 1 + 3) % 3;
-            if (down && !downPressed) selectedPauseItem = (selectedPauseItem + 1) % 3;
-            if (enter && !enterPressed) {
+            if (up)   selectedPauseItem = (selectedPauseItem - 1 + 3) % 3;
+            if (down) selectedPauseItem = (selectedPauseItem + 1) % 3;
+            if (enter) {
                 if (selectedPauseItem == 0) { SetState(PLAYING); }
                 if (selectedPauseItem == 1) { SetState(SETTINGS_MENU); }
                 if (selectedPauseItem == 2) { SetState(MAIN_MENU); }
             }
-            if (esc && !escPressed) { SetState(PLAYING); }
+            if (esc) { SetState(PLAYING); }
             break;
         case GAME_OVER:
-            if (enter && !enterPressed) SetState(MAIN_MENU);
+            if (enter) SetState(MAIN_MENU);
             break;
         default: break;
     }
-
-    upPressed=up; downPressed=down; leftPressed=left; rightPressed=right; enterPressed=enter; escPressed=esc;
 }
 
 void framebuffer_size_callback(GLFWwindow* /*window*/, int width, int height) {
@@ -321,39 +742,42 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
         game->lastX = xpos; game->lastY = ypos; game->firstMouse = false;
     }
 
-    float rawX = static_cast<float>(xpos - game->lastX);
-    float rawY = static_cast<float>(game->lastY - ypos);
+    game->pendingMouseX += static_cast<float>(xpos - game->lastX);
+    game->pendingMouseY += static_cast<float>(game->lastY - ypos);
     game->lastX = xpos; game->lastY = ypos;
+}
+
+void Game::applyMouseLook(const InputState& input) {
+    const float rawX = input.mouseDeltaX;
+    const float rawY = input.mouseDeltaY;
+    if (rawX == 0.0f && rawY == 0.0f) return;
 
     const float sensitivity = 0.1f;
     float xoffset = rawX * sensitivity;
     float yoffset = rawY * sensitivity;
 
-    if (game->boatSkinIndex == BoatSkinId::GOING_MERRY) {
-        if (game->shipCamera.mode == Camera::FIRST_PERSON) {
-            game->GetPlayer()->AdjustRotation(-xoffset);
-            float clampedPitch = glm::clamp(game->shipCamera.Pitch + yoffset, -89.0f, 89.0f);
-            game->shipCamera.SetPitch(clampedPitch);
+    if (boatSkinIndex == BoatSkinId::GOING_MERRY) {
+        if (shipCamera.mode == Camera::FIRST_PERSON) {
+            pendingYaw -= xoffset;
+            float clampedPitch = glm::clamp(shipCamera.Pitch + yoffset, -89.0f, 89.0f);
+            shipCamera.SetPitch(clampedPitch);
         } else {
-            game->shipCamera.ProcessMouseMovement(rawX, rawY);
+            shipCamera.ProcessMouseMovement(rawX, rawY);
         }
         return;
     }
 
-    if (game->isFirstPerson) {
-        if (game->boatSkinIndex == BoatSkinId::BIG_MOM) {
+    if (isFirstPerson) {
+        if (boatSkinIndex == BoatSkinId::BIG_MOM) {
             const float mouseSensitivity = 1.5f;
-            game->GetPlayer()->AdjustRotation(-xoffset * mouseSensitivity * 0.1f);
+            pendingYaw -= xoffset * mouseSensitivity * 0.1f;
         } else {
-            game->GetPlayer()->AdjustRotation(-xoffset);
+            pendingYaw -= xoffset;
         }
     } else {
-        game->cameraYaw   += xoffset;
-        game->cameraPitch += yoffset;
-        if (game->cameraPitch >  89.0f) game->cameraPitch =  89.0f;
-        if (game->cameraPitch < -89.0f) game->cameraPitch = -89.0f;
+        cameraYaw   += xoffset;
+        cameraPitch += yoffset;
+        if (cameraPitch >  89.0f) cameraPitch =  89.0f;
+        if (cameraPitch < -89.0f) cameraPitch = -89.0f;
     }
 }
-
-
-
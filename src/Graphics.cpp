@@ -1,5 +1,6 @@
 #include "Graphics.h"
 #include "BoatSkinIds.h"
+#include "Waves.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glad/glad.h>
 #include <iostream>
@@ -26,8 +27,11 @@ static FPCamPreset kFPCamBySkin[SKIN_COUNT] = {
 
 static inline int GetSafeSkinIndex(int idx){ return (idx < 0 || idx >= SKIN_COUNT) ? 0 : idx; }
 
-static float kBoatWaterlineBySkin[SKIN_COUNT] = { 0.95f, 2.6f, 1.9f, 1.4f, 2.2f, 0.25f };
-static float kEnemyWaterlineOffset = 0.39f;
+// Blend two headings in degrees along the shorter arc.
+static inline float LerpAngleDeg(float from, float to, float t) {
+    float delta = std::fmod(to - from + 540.0f, 360.0f) - 180.0f;
+    return from + delta * t;
+}
 
 static const float kCubeVerts[] = {
     // pos                // normal
@@ -51,15 +55,33 @@ static const float kCubeVerts[] = {
      0.5f,-0.5f, 0.5f,    0,-1,0, -0.5f,-0.5f, 0.5f,   0,-1,0, -0.5f,-0.5f,-0.5f,   0,-1,0,
 };
 
-static float kWaterVerts[] = {
-    -WATER_HALF, WATER_LEVEL, -WATER_HALF,  0,1,0,
-     WATER_HALF, WATER_LEVEL, -WATER_HALF,  0,1,0,
-     WATER_HALF, WATER_LEVEL,  WATER_HALF,  0,1,0,
-
-    -WATER_HALF, WATER_LEVEL, -WATER_HALF,  0,1,0,
-     WATER_HALF, WATER_LEVEL,  WATER_HALF,  0,1,0,
-    -WATER_HALF, WATER_LEVEL,  WATER_HALF,  0,1,0,
-};
+// The water is a grid the vertex shader displaces, fine enough to show the swell the boats
+// ride (the shortest wave is about 60 units long). It follows the camera in whole cells, so
+// each vertex samples the same world XZ from frame to frame.
+static constexpr int   WATER_CELLS = 250;
+static constexpr float WATER_CELL  = 2.0f * WATER_HALF / WATER_CELLS;
+static constexpr GLsizei WATER_INDEX_COUNT = WATER_CELLS * WATER_CELLS * 6;
+
+static void buildWaterGrid(std::vector<float>& verts, std::vector<GLuint>& indices) {
+    const int side = WATER_CELLS + 1;
+    verts.clear();
+    verts.reserve(static_cast<size_t>(side) * side * 6);
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            verts.insert(verts.end(), { -WATER_HALF + c * WATER_CELL, WATER_LEVEL, -WATER_HALF + r * WATER_CELL,
+                                        0.0f, 1.0f, 0.0f });
+        }
+    }
+    indices.clear();
+    indices.reserve(WATER_INDEX_COUNT);
+    for (int r = 0; r < WATER_CELLS; ++r) {
+        for (int c = 0; c < WATER_CELLS; ++c) {
+            const GLuint i = static_cast<GLuint>(r * side + c);
+            const GLuint below = i + static_cast<GLuint>(side);
+            indices.insert(indices.end(), { i, i + 1, below + 1, i, below + 1, below });
+        }
+    }
+}
 
 static const float kSkyboxVerts[] = {
     -1,-1,-1,  1,-1,-1,  1, 1,-1,   1, 1,-1, -1, 1,-1, -1,-1,-1,
@@ -161,6 +183,7 @@ void Graphics::Render(const Player& player,
                       const ProjectileManager& projectileManager,
                       const MountainManager& mountainManager,
                       float waveTime,
+                      float interpolationAlpha,
                       float cameraYaw,
                       float cameraPitch,
                       float cameraDistance,
@@ -179,23 +202,25 @@ void Graphics::Render(const Player& player,
     // camera
     glm::mat4 view(1.0f);
     glm::vec3 viewPos(0.0f);
-    const glm::vec3 playerPos = player.GetPosition();
+    const float     alpha          = interpolationAlpha;
+    const glm::vec3 playerPos      = player.GetInterpolatedPosition(alpha);
+    const float     playerRotation = player.GetInterpolatedRotation(alpha);
 
     const int skin = GetSafeSkinIndex(boatSkinIndex);
     glm::vec3 basePos = playerPos;
     if (skin == SKIN_BIGMOM) {
-        basePos.y = WATER_LEVEL + kBoatWaterlineBySkin[skin];
+        basePos.y = WATER_LEVEL + ModelManager::kPlayerWaterline[skin];
     }
 
     bool isGoingMerry = (boatSkinIndex == BoatSkinId::GOING_MERRY);
 
     if (isGoingMerry) {
-        float shipYawRad = glm::radians(player.GetRotation());
+        float shipYawRad = glm::radians(playerRotation);
         glm::mat4 gmView = shipCamera.GetViewMatrix(playerPos, shipFront, shipYawRad);
         view    = gmView;
         viewPos = shipCamera.Position;
     } else if (isFirstPerson) {
-        float yawRad = glm::radians(player.GetRotation());
+        float yawRad = glm::radians(playerRotation);
         glm::vec3 forward = glm::normalize(glm::vec3(std::sin(yawRad), 0.0f, std::cos(yawRad)));
         glm::vec3 right   = glm::normalize(glm::cross(forward, glm::vec3(0,1,0)));
 
@@ -281,9 +306,10 @@ void Graphics::Render(const Player& player,
     glUniform1f(exposureLoc,   1.35f);
     glUniform1f(ambientBoostL, 1.12f);
 
-    glUniform2f(waterCenterLoc, viewPos.x, viewPos.z);
-    glUniform1f(waterAmpLoc,    0.10f);
-    glUniform1f(waterSpeedLoc,  1.0f);
+    glUniform2f(waterCenterLoc, std::floor(viewPos.x / WATER_CELL) * WATER_CELL,
+                                std::floor(viewPos.z / WATER_CELL) * WATER_CELL);
+    glUniform1f(waterAmpLoc,    kWaveAmplitude);
+    glUniform1f(waterSpeedLoc,  kWaveSpeed);
     glUniform1i(rainbowLoc, enableRainbowWater ? 1 : 0);
 
     // skybox
@@ -312,13 +338,14 @@ void Graphics::Render(const Player& player,
     }
 
     // boats
-    glm::vec3 standardBoatScale(5.0f);
+    glm::vec3 standardBoatScale(ModelManager::kBoatScale);
 
     // player boat 
     glm::vec3 playerBoatPosition = playerPos;
     if (skin != SKIN_GOING_MERRY) {
-        playerBoatPosition.y = WATER_LEVEL + kBoatWaterlineBySkin[skin];
+        playerBoatPosition.y = WATER_LEVEL + ModelManager::kPlayerWaterline[skin];
     }
+    playerBoatPosition.y += player.GetHeave();
 
     if (skin == SKIN_GOING_MERRY) {
         GLint gmUseTex = glGetUniformLocation(goingMerryShader, "use_texture");
@@ -326,50 +353,55 @@ void Graphics::Render(const Player& player,
         if (gmSampler >= 0) glUniform1i(gmSampler, 0);
         if (gmUseTex >= 0) glUniform1i(gmUseTex, 1);
         glUseProgram(goingMerryShader);
-        modelManager->DrawPlayerBoat(goingMerryShader, boatSkinIndex, playerBoatPosition, player.GetRotation(), standardBoatScale);
+        modelManager->DrawPlayerBoat(goingMerryShader, boatSkinIndex, playerBoatPosition, playerRotation, standardBoatScale,
+                                     player.GetPitch(), player.GetRoll());
         glUseProgram(shaderProgram);
     } else {
         glUniform1i(useTexLoc, 1);
         glUniform1i(invertVLoc, modelManager && modelManager->ShouldFlipVForSkin(boatSkinIndex) ? 1 : 0);
         glUniform1i(partyModeLoc, enablePartyModeForPlayer ? 1 : 0);
         glUniform3f(objColorLoc, 1.0f, 1.0f, 1.0f);
-        modelManager->DrawPlayerBoat(shaderProgram, boatSkinIndex, playerBoatPosition, player.GetRotation(), standardBoatScale);
+        modelManager->DrawPlayerBoat(shaderProgram, boatSkinIndex, playerBoatPosition, playerRotation, standardBoatScale,
+                                     player.GetPitch(), player.GetRoll());
     }
 
     // enemies 
     glUniform1i(partyModeLoc, 0);
-    for (const auto& e : enemyManager.GetEnemies()) {
-        if (!e.active) continue;
-        glm::vec3 enemyPos = e.position;
-        enemyPos.y = WATER_LEVEL + kEnemyWaterlineOffset;
+    const EnemyStore& enemies = enemyManager.GetEnemies();
+    for (size_t i = 0; i < enemies.Size(); ++i) {
+        if (!enemies.active[i]) continue;
+        glm::vec3 enemyPos = glm::mix(enemies.prevPosition[i], enemies.Position(i), alpha);
+        enemyPos.y = WATER_LEVEL + ModelManager::kEnemyWaterline + enemies.heave[i];
 
         glUniform1i(useTexLoc, 1);
         glUniform1i(invertVLoc, modelManager && modelManager->ShouldFlipVEnemy() ? 1 : 0);
-        modelManager->DrawEnemyBoat(shaderProgram, enemyPos, e.rotation, standardBoatScale);
+        modelManager->DrawEnemyBoat(shaderProgram, enemyPos,
+                                    LerpAngleDeg(enemies.PrevRotationDeg(i), enemies.RotationDeg(i), alpha), standardBoatScale,
+                                    enemies.pitch[i], enemies.roll[i]);
     }
 
     // ---- Projectiles ----
     const float kPlayerCannonballScale = 0.15f; 
     const float kEnemyCannonballScale  = 0.12f; 
 
-    for (const auto& p : projectileManager.GetProjectiles()) {
-    if (!p.active) continue;
-
+    const ProjectileStore& projs = projectileManager.GetProjectiles();
+    for (size_t i = 0; i < projs.Size(); ++i) {
     glUniform1i(useTexLoc, 1);
     glUniform1i(invertVLoc, 0);
 
-    const float s = p.isPlayerOwned ? kPlayerCannonballScale : kEnemyCannonballScale;
+    const float s = projs.playerOwned[i] ? kPlayerCannonballScale : kEnemyCannonballScale;
 
     if (modelManager) {
-        modelManager->DrawCannonball(shaderProgram, p.position, s);
+        modelManager->DrawCannonball(shaderProgram, projectileManager.InterpolatedPosition(i, alpha), s);
     }
 
-    if (!p.isPlayerOwned) {
+    if (!projs.playerOwned[i]) {
         glm::vec3 smokeCol(0.5f);
         glUniform1i(useTexLoc, 0);
-        for (const auto& sPos : p.smokeTrail) {
+        const SmokeRing trail = projectileManager.SmokeTrail(i);
+        for (int k = 0; k < trail.Size(); ++k) {
             glUniform3fv(objColorLoc, 1, &smokeCol[0]);
-            drawCube(sPos, 0.0f, glm::vec3(0.12f), smokeCol);
+            drawCube(trail[k], 0.0f, glm::vec3(0.12f), smokeCol);
         }
     }
 }
@@ -390,12 +422,18 @@ void Graphics::setupBuffers() {
     glEnableVertexAttribArray(1);
 
     // Water
-    GLuint waterVBO;
+    std::vector<float>  waterVerts;
+    std::vector<GLuint> waterIndices;
+    buildWaterGrid(waterVerts, waterIndices);
+    GLuint waterVBO, waterEBO;
     glGenVertexArrays(1, &waterVAO);
     glGenBuffers(1, &waterVBO);
+    glGenBuffers(1, &waterEBO);
     glBindVertexArray(waterVAO);
     glBindBuffer(GL_ARRAY_BUFFER, waterVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(kWaterVerts), kWaterVerts, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, waterVerts.size() * sizeof(float), waterVerts.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, waterEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, waterIndices.size() * sizeof(GLuint), waterIndices.data(), GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6*sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6*sizeof(float), (void*)(3*sizeof(float)));
@@ -521,6 +559,7 @@ void main() {
         pos.z += waterCenter.y;
         pos.y  = WATER_LEVEL;
 
+        // The same sea as Waves.h (kWaveTerms); boats float on its CPU copy, so change both.
         float t = time * waterSpeed;
 
         float f1 = 0.06; float a1 = 1.2;
@@ -728,7 +767,7 @@ void Graphics::drawWater(const glm::vec3&, float, bool, bool) {
     glUniform1i(isWaterLoc, 1);
     glUniform1i(invertVLoc, 0);
 
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glDrawElements(GL_TRIANGLES, WATER_INDEX_COUNT, GL_UNSIGNED_INT, nullptr);
     glBindVertexArray(0);
 }
 
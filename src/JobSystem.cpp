@@ -0,0 +1,135 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+// Set once by each worker; every other thread stays at 0.
+static thread_local unsigned tlsSlot = 0;
+
+JobSystem::JobSystem(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned workerCount = threads - 1;
+    for (unsigned i = 0; i < workerCount; ++i) queues.push_back(std::make_unique<Queue>());
+    workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) workers.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+unsigned JobSystem::CurrentSlot() {
+    return tlsSlot;
+}
+
+void JobSystem::submit(const Task& prototype, size_t count, size_t grain) {
+    const size_t chunks = (count + grain - 1) / grain;
+    prototype.remaining->store(chunks, std::memory_order_relaxed);
+    {
+        // Counted before the pushes so a worker's pop can never take the count below zero.
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queued.fetch_add(chunks, std::memory_order_release);
+    }
+
+    // Deal chunks round-robin so every worker starts with a share; stealing evens out the rest.
+    const unsigned n = static_cast<unsigned>(queues.size());
+    for (size_t c = 0; c < chunks; ++c) {
+        Task task = prototype;
+        task.begin = c * grain;
+        task.end   = std::min(count, (c + 1) * grain);
+        push(static_cast<unsigned>(c % n), task);
+    }
+    wake.notify_all();
+
+    HelpUntilZero(*prototype.remaining);
+}
+
+void JobSystem::Enqueue(void (*fn)(void* ctx, unsigned slot), void* ctx) {
+    if (workers.empty()) {
+        fn(ctx, CurrentSlot());
+        return;
+    }
+    Task task;
+    task.job = fn;
+    task.ctx = ctx;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queued.fetch_add(1, std::memory_order_release);
+    }
+    // Workers keep what they spawn (it is likely to touch the same data); others spread it.
+    const unsigned slot = CurrentSlot();
+    const unsigned queue = slot != 0 ? slot - 1 : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    push(queue, task);
+    wake.notify_one();
+}
+
+void JobSystem::HelpUntilZero(const std::atomic<size_t>& counter) {
+    while (counter.load(std::memory_order_acquire) != 0) {
+        if (!runOne()) std::this_thread::yield();
+    }
+}
+
+void JobSystem::push(unsigned queue, const Task& task) {
+    Queue& q = *queues[queue];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    q.tasks.push_back(task);
+}
+
+bool JobSystem::popOwn(unsigned queue, Task& out) {
+    Queue& q = *queues[queue];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty()) return false;
+    out = q.tasks.back();
+    q.tasks.pop_back();
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+// Tries every other queue once, starting after the thief's own. Threads outside the pool
+// pass queues.size() and so try them all.
+bool JobSystem::steal(unsigned thief, Task& out) {
+    const unsigned n = static_cast<unsigned>(queues.size());
+    for (unsigned k = 1; k <= n; ++k) {
+        const unsigned victim = (thief + k) % n;
+        if (victim == thief) continue;
+        Queue& q = *queues[victim];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) continue;
+        out = q.tasks.front();
+        q.tasks.pop_front();
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+// Runs one queued task on the calling thread, if there is any.
+bool JobSystem::runOne() {
+    const unsigned slot = CurrentSlot();
+    const unsigned own  = slot != 0 ? slot - 1 : static_cast<unsigned>(queues.size());
+    Task task;
+    if ((slot != 0 && popOwn(own, task)) || steal(own, task)) {
+        runTask(task);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::runTask(const Task& task) {
+    if (task.job) task.job(task.ctx, CurrentSlot());
+    else          task.run(task.ctx, task.begin, task.end, CurrentSlot());
+    if (task.remaining) task.remaining->fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void JobSystem::workerLoop(unsigned index) {
+    tlsSlot = index + 1;
+    for (;;) {
+        if (runOne()) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) != 0; });
+        if (stopping) return;
+    }
+}
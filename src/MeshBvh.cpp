@@ -0,0 +1,145 @@
+#include "MeshBvh.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+// Boxes are grown by this fraction of the mesh's size, so rounding in the slab test never
+// culls a triangle the exact test would touch.
+static constexpr float kBoxPad = 1e-5f;
+
+void MeshBvh::Clear() {
+    nodes.clear();
+    tris.clear();
+}
+
+void MeshBvh::Build(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices) {
+    Clear();
+    const uint32_t count = static_cast<uint32_t>(indices.size() / 3);
+    std::vector<glm::vec3> centroids, lo, hi;
+    std::vector<Triangle> source;
+    centroids.reserve(count);
+    lo.reserve(count);
+    hi.reserve(count);
+    source.reserve(count);
+    for (uint32_t t = 0; t < count; ++t) {
+        const uint32_t i0 = indices[3 * t], i1 = indices[3 * t + 1], i2 = indices[3 * t + 2];
+        if (i0 >= positions.size() || i1 >= positions.size() || i2 >= positions.size()) continue;
+        const glm::vec3& p0 = positions[i0];
+        const glm::vec3& p1 = positions[i1];
+        const glm::vec3& p2 = positions[i2];
+        source.push_back(Triangle{ p0, p1 - p0, p2 - p0 });
+        lo.push_back(glm::min(p0, glm::min(p1, p2)));
+        hi.push_back(glm::max(p0, glm::max(p1, p2)));
+        centroids.push_back((p0 + p1 + p2) * (1.0f / 3.0f));
+    }
+    if (source.empty()) return;
+
+    std::vector<uint32_t> order(source.size());
+    std::iota(order.begin(), order.end(), 0u);
+    nodes.reserve(2 * source.size() / kLeafSize + 1);
+    build(order, 0, static_cast<uint32_t>(order.size()), centroids, lo, hi);
+
+    tris.reserve(source.size());
+    for (uint32_t t : order) tris.push_back(source[t]);
+
+    const glm::vec3 pad((glm::length(nodes[0].max - nodes[0].min) + 1e-6f) * kBoxPad);
+    for (Node& n : nodes) {
+        n.min -= pad;
+        n.max += pad;
+    }
+}
+
+// Splits at the median centroid along the longest axis of the centroids' box, which keeps
+// the tree balanced and its depth near log2 of the leaf count.
+uint32_t MeshBvh::build(std::vector<uint32_t>& order, uint32_t begin, uint32_t end,
+                        const std::vector<glm::vec3>& centroids, const std::vector<glm::vec3>& lo,
+                        const std::vector<glm::vec3>& hi) {
+    const uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+    glm::vec3 mn = lo[order[begin]], mx = hi[order[begin]];
+    glm::vec3 cmn = centroids[order[begin]], cmx = cmn;
+    for (uint32_t k = begin + 1; k < end; ++k) {
+        const uint32_t t = order[k];
+        mn = glm::min(mn, lo[t]);
+        mx = glm::max(mx, hi[t]);
+        cmn = glm::min(cmn, centroids[t]);
+        cmx = glm::max(cmx, centroids[t]);
+    }
+    nodes[index].min = mn;
+    nodes[index].max = mx;
+
+    const glm::vec3 spread = cmx - cmn;
+    if (end - begin <= kLeafSize || std::max(spread.x, std::max(spread.y, spread.z)) <= 0.0f) {
+        nodes[index].first = begin;
+        nodes[index].count = end - begin;
+        return index;
+    }
+
+    const int axis = (spread.x >= spread.y && spread.x >= spread.z) ? 0 : (spread.y >= spread.z ? 1 : 2);
+    const uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                     [&](uint32_t l, uint32_t r) { return centroids[l][axis] < centroids[r][axis]; });
+    build(order, begin, mid, centroids, lo, hi);
+    const uint32_t right = build(order, mid, end, centroids, lo, hi);
+    nodes[index].first = right;
+    nodes[index].count = 0;
+    return index;
+}
+
+// Moller-Trumbore, with the hit distance limited to the segment.
+bool MeshBvh::SegmentHitsTriangle(const glm::vec3& a, const glm::vec3& d,
+                                  const glm::vec3& v0, const glm::vec3& e1, const glm::vec3& e2) {
+    const glm::vec3 p = glm::cross(d, e2);
+    const float det = glm::dot(e1, p);
+    if (det == 0.0f) return false; // segment parallel to the triangle
+    const float invDet = 1.0f / det;
+    const glm::vec3 s = a - v0;
+    const float u = glm::dot(s, p) * invDet;
+    if (u < 0.0f || u > 1.0f) return false;
+    const glm::vec3 q = glm::cross(s, e1);
+    const float v = glm::dot(d, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f) return false;
+    const float t = glm::dot(e2, q) * invDet;
+    return t >= 0.0f && t <= 1.0f;
+}
+
+// Slab test against the segment a + t d, t in [0, 1]. A zero component of d gets a huge
+// reciprocal instead of infinity, so a box face through a never makes 0 * inf.
+static bool segmentTouchesBox(const glm::vec3& a, const glm::vec3& inv, const glm::vec3& mn, const glm::vec3& mx) {
+    float tmin = 0.0f, tmax = 1.0f;
+    for (int k = 0; k < 3; ++k) {
+        const float t0 = (mn[k] - a[k]) * inv[k];
+        const float t1 = (mx[k] - a[k]) * inv[k];
+        tmin = std::max(tmin, std::min(t0, t1));
+        tmax = std::min(tmax, std::max(t0, t1));
+    }
+    return tmin <= tmax;
+}
+
+bool MeshBvh::SegmentHits(const glm::vec3& a, const glm::vec3& b) const {
+    if (nodes.empty()) return false;
+    const glm::vec3 d = b - a;
+    glm::vec3 inv;
+    for (int k = 0; k < 3; ++k)
+        inv[k] = (std::fabs(d[k]) > 1e-20f) ? 1.0f / d[k] : (d[k] < 0.0f ? -1e30f : 1e30f);
+
+    // Depth stays near log2 of the leaf count, far below the stack's size.
+    uint32_t stack[64];
+    int top = 0;
+    uint32_t n = 0;
+    for (;;) {
+        const Node& node = nodes[n];
+        if (segmentTouchesBox(a, inv, node.min, node.max)) {
+            if (node.count == 0) {
+                stack[top++] = node.first;
+                n = n + 1;
+                continue;
+            }
+            for (uint32_t t = node.first; t < node.first + node.count; ++t) {
+                if (SegmentHitsTriangle(a, d, tris[t].v0, tris[t].e1, tris[t].e2)) return true;
+            }
+        }
+        if (top == 0) return false;
+        n = stack[--top];
+    }
+}
@@ -367,3 +367,39 @@ void Model::Draw(unsigned int shaderProgram) {
         m.Draw(shaderProgram);
     }
 }
+
+static void collectTriangles(const aiNode* node, const aiScene* scene, const aiMatrix4x4& parent, bool bake,
+                             std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices) {
+    const aiMatrix4x4 transform = bake ? parent * node->mTransformation : parent;
+    for (unsigned int m = 0; m < node->mNumMeshes; ++m) {
+        const aiMesh* mesh = scene->mMeshes[node->mMeshes[m]];
+        const uint32_t base = static_cast<uint32_t>(positions.size());
+        for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+            const aiVector3D p = transform * mesh->mVertices[i];
+            positions.emplace_back(p.x, p.y, p.z);
+        }
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+            const aiFace& face = mesh->mFaces[f];
+            if (face.mNumIndices != 3) continue; // points and lines have no surface
+            indices.push_back(base + face.mIndices[0]);
+            indices.push_back(base + face.mIndices[1]);
+            indices.push_back(base + face.mIndices[2]);
+        }
+    }
+    for (unsigned int i = 0; i < node->mNumChildren; ++i)
+        collectTriangles(node->mChildren[i], scene, transform, bake, positions, indices);
+}
+
+bool LoadModelTriangles(const std::string& path, bool bakeNodeTransforms,
+                        std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices) {
+    positions.clear();
+    indices.clear();
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices);
+    if (!scene || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) || !scene->mRootNode) {
+        std::cerr << "Assimp error loading '" << path << "': " << importer.GetErrorString() << std::endl;
+        return false;
+    }
+    collectTriangles(scene->mRootNode, scene, aiMatrix4x4(), bakeNodeTransforms, positions, indices);
+    return !indices.empty();
+}
@@ -10,6 +10,7 @@
 #include <limits>
 #include <algorithm>
 #include <cstdlib>
+#include <cmath>
 
 ModelManager::ModelManager() {}
 ModelManager::~ModelManager() {}
@@ -65,8 +66,10 @@ void ModelManager::NodeMesh::Draw(unsigned int shader) const {
 }
 
 float ModelManager::computeXZLengthScale(const Model& model) {
-    const glm::vec3 mn = model.getBoundsMin();
-    const glm::vec3 mx = model.getBoundsMax();
+    return xzLengthScale(model.getBoundsMin(), model.getBoundsMax());
+}
+
+float ModelManager::xzLengthScale(const glm::vec3& mn, const glm::vec3& mx) {
     const float xExtent = mx.x - mn.x;
     const float zExtent = mx.z - mn.z;
     const float xzMax   = std::max(xExtent, zExtent);
@@ -82,6 +85,29 @@ glm::mat4 ModelManager::makeOrient(const EulerOffset& off) {
     return m;
 }
 
+// After the yaw the bow points along +Z and Buoyancy's roll side along +X, so pitching the
+// bow up turns about -X and rolling that side up turns about +Z.
+glm::mat4 ModelManager::boatTransform(glm::vec3 position, float rotation, float pitch, float roll,
+                                      const EulerOffset& orient, glm::vec3 scale) {
+    glm::mat4 T = glm::translate(glm::mat4(1.0f), position);
+    glm::mat4 Y = glm::rotate(glm::mat4(1.0f), glm::radians(rotation), glm::vec3(0,1,0));
+    glm::mat4 P = glm::rotate(glm::mat4(1.0f), -pitch, glm::vec3(1,0,0));
+    glm::mat4 R = glm::rotate(glm::mat4(1.0f), roll, glm::vec3(0,0,1));
+    glm::mat4 O = makeOrient(orient);
+    glm::mat4 S = glm::scale(glm::mat4(1.0f), scale);
+    return T * Y * P * R * O * S;
+}
+
+// Here the bow is +X and the roll side -Z: pitch turns about +Z, roll about +X.
+glm::mat4 ModelManager::goingMerryTransform(glm::vec3 position, float rotation, float pitch, float roll) {
+    glm::mat4 m(1.0f);
+    m = glm::translate(m, position);
+    m = glm::rotate(m, glm::radians(rotation), glm::vec3(0,1,0));
+    m = glm::rotate(m, pitch, glm::vec3(0,0,1));
+    m = glm::rotate(m, roll, glm::vec3(1,0,0));
+    return glm::scale(m, glm::vec3(0.4f));
+}
+
 glm::mat4 ModelManager::aiMatrixToGlm(const aiMatrix4x4& from) {
     glm::mat4 to;
     to[0][0] = from.a1; to[1][0] = from.a2; to[2][0] = from.a3; to[3][0] = from.a4;
@@ -162,16 +188,15 @@ void ModelManager::DrawPlayerBoat(unsigned int shader,
                                   int boatSkinIndex,
                                   glm::vec3 position,
                                   float rotation,
-                                  glm::vec3 scale) {
+                                  glm::vec3 scale,
+                                  float pitch,
+                                  float roll) {
     if (boatSkinIndex == BoatSkinId::GOING_MERRY) {
         if (goingMerryMeshes.empty()) {
             loadGoingMerryModel();
             if (goingMerryMeshes.empty()) return;
         }
-        glm::mat4 modelBase(1.0f);
-        modelBase = glm::translate(modelBase, position);
-        modelBase = glm::rotate(modelBase, glm::radians(rotation), glm::vec3(0,1,0));
-        modelBase = glm::scale(modelBase, glm::vec3(0.4f));
+        const glm::mat4 modelBase = goingMerryTransform(position, rotation, pitch, roll);
 
         GLint modelLoc = glGetUniformLocation(shader, "model");
         for (const auto& mesh : goingMerryMeshes) {
@@ -202,11 +227,7 @@ void ModelManager::DrawPlayerBoat(unsigned int shader,
     glm::vec3 adjustedPos   = position;
     adjustedPos.y += modelVerticalOffsets[boatSkinIndex];
 
-    glm::mat4 T = glm::translate(glm::mat4(1.0f), adjustedPos);
-    glm::mat4 Y = glm::rotate(glm::mat4(1.0f), glm::radians(rotation), glm::vec3(0,1,0));
-    glm::mat4 O = makeOrient(playerOrient[boatSkinIndex]);
-    glm::mat4 S = glm::scale(glm::mat4(1.0f), adjustedScale);
-    glm::mat4 M = T * Y * O * S;
+    glm::mat4 M = boatTransform(adjustedPos, rotation, pitch, roll, playerOrient[boatSkinIndex], adjustedScale);
 
     glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, &M[0][0]);
     mdl->Draw(shader);
@@ -215,7 +236,9 @@ void ModelManager::DrawPlayerBoat(unsigned int shader,
 void ModelManager::DrawEnemyBoat(unsigned int shader,
                                  glm::vec3 position,
                                  float rotation,
-                                 glm::vec3 scale) {
+                                 glm::vec3 scale,
+                                 float pitch,
+                                 float roll) {
     Model* mdl = enemyBoat ? enemyBoat.get()
                            : (playerBoats.count(0) ? playerBoats.at(0).get() : nullptr);
     if (!mdl) { std::cerr << "No enemy model available.\n"; return; }
@@ -227,16 +250,85 @@ void ModelManager::DrawEnemyBoat(unsigned int shader,
     glm::vec3 adjustedPos   = position;
     adjustedPos.y += enemyVerticalOffset;
 
-    glm::mat4 T = glm::translate(glm::mat4(1.0f), adjustedPos);
-    glm::mat4 Y = glm::rotate(glm::mat4(1.0f), glm::radians(rotation), glm::vec3(0,1,0));
-    glm::mat4 O = makeOrient(enemyOrient);
-    glm::mat4 S = glm::scale(glm::mat4(1.0f), adjustedScale);
-    glm::mat4 M = T * Y * O * S;
+    glm::mat4 M = boatTransform(adjustedPos, rotation, pitch, roll, enemyOrient, adjustedScale);
 
     glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, &M[0][0]);
     mdl->Draw(shader);
 }
 
+// Reads the same files LoadAllBoatModels does, geometry only. The enemy falls back to
+// player model 0 the way DrawEnemyBoat does.
+void ModelManager::LoadBoatHulls() {
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t>  indices;
+    auto load = [&](const std::string& path, bool bake, BoatHull& hull) {
+        hull = BoatHull();
+        if (!LoadModelTriangles(path, bake, positions, indices)) return;
+        glm::vec3 mn(std::numeric_limits<float>::max()), mx(-std::numeric_limits<float>::max());
+        for (const glm::vec3& p : positions) {
+            mn = glm::min(mn, p);
+            mx = glm::max(mx, p);
+        }
+        hull.lengthScale = xzLengthScale(mn, mx);
+        hull.bvh.Build(positions, indices);
+    };
+
+    size_t triangles = 0;
+    for (int i = 0; i < static_cast<int>(boatModelPaths.size()); ++i) {
+        load(boatModelPaths[i], i == BoatSkinId::GOING_MERRY, playerHulls[i]);
+        triangles += playerHulls[i].bvh.TriangleCount();
+    }
+    load("3D Model/marine_ship.glb", false, enemyHull);
+    if (enemyHull.bvh.Empty()) enemyHull = playerHulls[0];
+    triangles += enemyHull.bvh.TriangleCount();
+
+    int loaded = 0;
+    for (const BoatHull& hull : playerHulls) loaded += hull.bvh.Empty() ? 0 : 1;
+    std::cout << "Boat hulls: " << loaded << " of " << playerHulls.size() << " skins, enemy "
+              << (enemyHull.bvh.Empty() ? "MISSING" : "OK") << ", " << triangles << " triangles\n";
+}
+
+int ModelManager::hullSkin(int boatSkinIndex) const {
+    if (boatSkinIndex == BoatSkinId::GOING_MERRY)
+        return playerHulls[boatSkinIndex].bvh.Empty() ? -1 : boatSkinIndex;
+    if (boatSkinIndex < 0 || boatSkinIndex >= static_cast<int>(playerHulls.size())) boatSkinIndex = 0;
+    if (!playerHulls[boatSkinIndex].bvh.Empty()) return boatSkinIndex;
+    return playerHulls[0].bvh.Empty() ? -1 : 0;
+}
+
+const MeshBvh* ModelManager::PlayerHull(int boatSkinIndex) const {
+    const int skin = hullSkin(boatSkinIndex);
+    return (skin < 0) ? nullptr : &playerHulls[skin].bvh;
+}
+
+glm::mat4 ModelManager::EnemyHullTransform(glm::vec3 position, float rotation, glm::vec3 scale,
+                                           float pitch, float roll) const {
+    position.y += enemyVerticalOffset;
+    return boatTransform(position, rotation, pitch, roll, enemyOrient,
+                         scale * enemyHull.lengthScale * enemyScaleAdjustment);
+}
+
+glm::mat4 ModelManager::PlayerHullTransform(int boatSkinIndex, glm::vec3 position, float rotation, glm::vec3 scale,
+                                            float pitch, float roll) const {
+    const int skin = std::max(hullSkin(boatSkinIndex), 0);
+    if (skin == BoatSkinId::GOING_MERRY) return goingMerryTransform(position, rotation, pitch, roll);
+    position.y += modelVerticalOffsets[skin];
+    return boatTransform(position, rotation, pitch, roll, playerOrient[skin],
+                         scale * playerHulls[skin].lengthScale * modelScaleAdjustments[skin]);
+}
+
+float ModelManager::HullRadius(const MeshBvh& hull, const glm::mat4& transform) {
+    const glm::vec3 mn = hull.BoundsMin(), mx = hull.BoundsMax();
+    const glm::vec3 origin(transform[3]);
+    float r2 = 0.0f;
+    for (int corner = 0; corner < 8; ++corner) {
+        const glm::vec3 c((corner & 1) ? mx.x : mn.x, (corner & 2) ? mx.y : mn.y, (corner & 4) ? mx.z : mn.z);
+        const glm::vec3 d = glm::vec3(transform * glm::vec4(c, 1.0f)) - origin;
+        r2 = std::max(r2, glm::dot(d, d));
+    }
+    return std::sqrt(r2);
+}
+
 void ModelManager::DrawCannonball(unsigned int shader,
                                   glm::vec3 position,
                                   float uniformScale) {
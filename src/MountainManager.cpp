@@ -1,8 +1,20 @@
 #include "MountainManager.h"
+#include "Random.h"
 #include <glm/gtc/constants.hpp>
-#include <cstdlib>
-#include <ctime>
 #include <algorithm>
+#include <bit>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// As in EnemyKernel.cpp: no fused multiply-adds, so the scalar tails round like the
+// vector blocks.
+#if defined(__GNUC__) && !defined(__clang__)
+#define NO_FP_CONTRACT __attribute__((optimize("fp-contract=off")))
+#else
+#define NO_FP_CONTRACT
+#endif
 
 
 // Tunables / constants
@@ -21,17 +33,14 @@ static constexpr float kMountainMeshBaseRadius = 3.0f;
 static constexpr int kPlaceTries = 64;
 static constexpr int kNumMountainTextures = 5;
 
-// Helpers
-static float frand01() {
-    return static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
-}
-
-static float frandRange(float a, float b) {
-    return a + (b - a) * frand01();
-}
+// Collision index: below kLinearScanMax mountains one vectorized pass over all of them
+// beats walking grid cells.
+static constexpr float  kIndexCellSize = 64.0f;
+static constexpr size_t kLinearScanMax = 32;
 
-static glm::vec2 randDir2() {
-    float ang = frandRange(0.0f, 2.0f * glm::pi<float>());
+// Helpers
+static glm::vec2 randDir2(Rng& rng) {
+    float ang = rng.Range(0.0f, 2.0f * glm::pi<float>());
     return glm::vec2(std::cos(ang), std::sin(ang));
 }
 
@@ -41,26 +50,137 @@ static float dist2XZ(const glm::vec3& a, const glm::vec3& b) {
     return dx*dx + dz*dz;
 }
 
+static int indexCellOf(float v) { return static_cast<int>(std::floor(v * (1.0f / kIndexCellSize))); }
+
+static uint32_t indexBucketOf(int cx, int cz, uint32_t mask) {
+    return (static_cast<uint32_t>(cx) * 73856093u ^ static_cast<uint32_t>(cz) * 19349663u) & mask;
+}
+
+// True if the circle (px, pz, r) overlaps any of the n circles in xs/zs/rs. Every path
+// does the same arithmetic as the scalar loop, so all of them give the same answer.
+NO_FP_CONTRACT
+static bool anyOverlap(const float* xs, const float* zs, const float* rs, size_t n,
+                       float px, float pz, float r) {
+    size_t i = 0;
+#if defined(__AVX__)
+    {
+        const __m256 vx = _mm256_set1_ps(px), vz = _mm256_set1_ps(pz), vr = _mm256_set1_ps(r);
+        for (; i + 8 <= n; i += 8) {
+            const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), vx);
+            const __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(zs + i), vz);
+            const __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dz, dz));
+            const __m256 rr = _mm256_add_ps(_mm256_loadu_ps(rs + i), vr);
+            if (_mm256_movemask_ps(_mm256_cmp_ps(d2, _mm256_mul_ps(rr, rr), _CMP_LT_OQ))) return true;
+        }
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    {
+        const __m128 vx = _mm_set1_ps(px), vz = _mm_set1_ps(pz), vr = _mm_set1_ps(r);
+        for (; i + 4 <= n; i += 4) {
+            const __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), vx);
+            const __m128 dz = _mm_sub_ps(_mm_loadu_ps(zs + i), vz);
+            const __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz));
+            const __m128 rr = _mm_add_ps(_mm_loadu_ps(rs + i), vr);
+            if (_mm_movemask_ps(_mm_cmplt_ps(d2, _mm_mul_ps(rr, rr)))) return true;
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        const float dx = xs[i] - px;
+        const float dz = zs[i] - pz;
+        const float rr = rs[i] + r;
+        if (dx*dx + dz*dz < rr*rr) return true;
+    }
+    return false;
+}
+
+// Sets blocked[k] for every line k in [0, n) that passes closer than rr to (cx, cz), and
+// leaves the others alone. The closest point is found by clamping the projection of the
+// center onto the line. As with anyOverlap, every path does the scalar loop's arithmetic.
+NO_FP_CONTRACT
+static void blockSightLines(const float* ax, const float* az, const float* bx, const float* bz, size_t n,
+                            float cx, float cz, float rr, uint8_t* blocked) {
+    size_t i = 0;
+#if defined(__AVX__)
+    {
+        const __m256 vcx = _mm256_set1_ps(cx), vcz = _mm256_set1_ps(cz), vrr = _mm256_set1_ps(rr * rr);
+        const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), tiny = _mm256_set1_ps(1e-12f);
+        for (; i + 8 <= n; i += 8) {
+            const __m256 ex = _mm256_sub_ps(_mm256_loadu_ps(ax + i), vcx);
+            const __m256 ez = _mm256_sub_ps(_mm256_loadu_ps(az + i), vcz);
+            const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(bx + i), _mm256_loadu_ps(ax + i));
+            const __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(bz + i), _mm256_loadu_ps(az + i));
+            const __m256 len2 = _mm256_max_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dz, dz)), tiny);
+            const __m256 along = _mm256_sub_ps(zero, _mm256_add_ps(_mm256_mul_ps(ex, dx), _mm256_mul_ps(ez, dz)));
+            const __m256 t = _mm256_min_ps(_mm256_max_ps(_mm256_div_ps(along, len2), zero), one);
+            const __m256 px = _mm256_add_ps(ex, _mm256_mul_ps(t, dx));
+            const __m256 pz = _mm256_add_ps(ez, _mm256_mul_ps(t, dz));
+            const __m256 d2 = _mm256_add_ps(_mm256_mul_ps(px, px), _mm256_mul_ps(pz, pz));
+            int mask = _mm256_movemask_ps(_mm256_cmp_ps(d2, vrr, _CMP_LT_OQ));
+            for (; mask != 0; mask &= mask - 1) blocked[i + std::countr_zero(static_cast<unsigned>(mask))] = 1;
+        }
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    {
+        const __m128 vcx = _mm_set1_ps(cx), vcz = _mm_set1_ps(cz), vrr = _mm_set1_ps(rr * rr);
+        const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), tiny = _mm_set1_ps(1e-12f);
+        for (; i + 4 <= n; i += 4) {
+            const __m128 ex = _mm_sub_ps(_mm_loadu_ps(ax + i), vcx);
+            const __m128 ez = _mm_sub_ps(_mm_loadu_ps(az + i), vcz);
+            const __m128 dx = _mm_sub_ps(_mm_loadu_ps(bx + i), _mm_loadu_ps(ax + i));
+            const __m128 dz = _mm_sub_ps(_mm_loadu_ps(bz + i), _mm_loadu_ps(az + i));
+            const __m128 len2 = _mm_max_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz)), tiny);
+            const __m128 along = _mm_sub_ps(zero, _mm_add_ps(_mm_mul_ps(ex, dx), _mm_mul_ps(ez, dz)));
+            const __m128 t = _mm_min_ps(_mm_max_ps(_mm_div_ps(along, len2), zero), one);
+            const __m128 px = _mm_add_ps(ex, _mm_mul_ps(t, dx));
+            const __m128 pz = _mm_add_ps(ez, _mm_mul_ps(t, dz));
+            const __m128 d2 = _mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(pz, pz));
+            int mask = _mm_movemask_ps(_mm_cmplt_ps(d2, vrr));
+            for (; mask != 0; mask &= mask - 1) blocked[i + std::countr_zero(static_cast<unsigned>(mask))] = 1;
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        const float ex = ax[i] - cx, ez = az[i] - cz;
+        const float dx = bx[i] - ax[i], dz = bz[i] - az[i];
+        const float len2 = std::max(dx*dx + dz*dz, 1e-12f);
+        const float t = std::min(std::max((0.0f - (ex*dx + ez*dz)) / len2, 0.0f), 1.0f);
+        const float px = ex + t*dx, pz = ez + t*dz;
+        if (px*px + pz*pz < rr*rr) blocked[i] = 1;
+    }
+}
+
 // MountainManager
 MountainManager::MountainManager()
-    : spawnTimer(0.0f)
-    , spawnInterval(0.5f) 
+    : spawnInterval(0.5f) 
 {
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
 }
 
-void MountainManager::Init() {
+void MountainManager::Init(Rng& randomStream) {
+    rng = &randomStream;
     mountains.clear();
     mountains.reserve(MAX_MOUNTAINS);
-    spawnTimer = 0.0f;
+    tick = 0;
+    spawnTimers.Reset(0);
+    spawnTimers.Schedule(1, 0); // the first Update
+    ++generation;
+    rebuildIndex();
+}
+
+void MountainManager::SetMountains(std::vector<Mountain> list) {
+    mountains = std::move(list);
+    ++generation;
+    rebuildIndex();
 }
 
 void MountainManager::Update(float dt, const glm::vec3& playerPosition) {
-    spawnTimer -= dt;
-    while (static_cast<int>(mountains.size()) < MAX_MOUNTAINS && spawnTimer <= 0.0f) {
+    spawnTimers.Advance(++tick, [&](uint64_t) {
         SpawnMountain(playerPosition);
-        spawnTimer += spawnInterval;
-    }
+        if (static_cast<int>(mountains.size()) < MAX_MOUNTAINS)
+            spawnTimers.Schedule(tick + TicksFor(spawnInterval, dt), 0);
+    });
 
     for (auto& m : mountains) {
         if (!m.active) continue;
@@ -70,30 +190,185 @@ void MountainManager::Update(float dt, const glm::vec3& playerPosition) {
     }
 }
 
-bool MountainManager::checkCollision(glm::vec3 p, float r) {
+bool MountainManager::checkCollision(const glm::vec3& p, float r) const {
+    return overlapsAny(p.x, p.z, r);
+}
+
+size_t MountainManager::checkCollisionBatch(std::span<const glm::vec3> positions, std::span<const float> radii,
+                                            std::span<uint8_t> outHit) const {
+    const bool sharedRadius = radii.size() == 1;
+    size_t hits = 0;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const bool hit = overlapsAny(positions[i].x, positions[i].z, sharedRadius ? radii[0] : radii[i]);
+        outHit[i] = hit ? 1 : 0;
+        hits += hit;
+    }
+    return hits;
+}
+
+bool MountainManager::overlapsAny(float x, float z, float r) const {
+    const size_t count = idxX.size();
+    if (count <= kLinearScanMax) return anyOverlap(idxX.data(), idxZ.data(), idxRadius.data(), count, x, z, r);
+
+    // Any mountain touching the circle has its center within r + idxMaxRadius of it.
+    const float reach = r + idxMaxRadius;
+    const int x0 = indexCellOf(x - reach), x1 = indexCellOf(x + reach);
+    const int z0 = indexCellOf(z - reach), z1 = indexCellOf(z + reach);
+    if (static_cast<uint64_t>(x1 - x0 + 1) * static_cast<uint64_t>(z1 - z0 + 1) > idxBucketMask + 1u)
+        return anyOverlap(idxX.data(), idxZ.data(), idxRadius.data(), count, x, z, r);
+
+    // Cells sharing a bucket only add candidates, and a bucket visited twice is harmless
+    // for a yes/no answer, so no per-entry cell check is needed here.
+    for (int cz = z0; cz <= z1; ++cz) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            const uint32_t b = indexBucketOf(cx, cz, idxBucketMask);
+            const uint32_t begin = idxBucketStart[b], end = idxBucketStart[b + 1];
+            if (begin != end && anyOverlap(idxX.data() + begin, idxZ.data() + begin, idxRadius.data() + begin,
+                                           end - begin, x, z, r))
+                return true;
+        }
+    }
+    return false;
+}
+
+size_t MountainManager::checkLineOfSightBatch(const SightLines& lines, float clearance) const {
+    const size_t n = lines.count;
+    std::fill(lines.blocked, lines.blocked + n, uint8_t(0));
+    if (n == 0 || idxX.empty()) return 0;
+
+    float minX = lines.fromX[0], maxX = minX, minZ = lines.fromZ[0], maxZ = minZ;
+    for (size_t k = 0; k < n; ++k) {
+        minX = std::min({ minX, lines.fromX[k], lines.toX[k] });
+        maxX = std::max({ maxX, lines.fromX[k], lines.toX[k] });
+        minZ = std::min({ minZ, lines.fromZ[k], lines.toZ[k] });
+        maxZ = std::max({ maxZ, lines.fromZ[k], lines.toZ[k] });
+    }
+
+    // Mountains whose circle reaches the box; the rest can't touch any line.
+    auto visit = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t m = begin; m < end; ++m) {
+            const float rr = idxRadius[m] + clearance;
+            if (idxX[m] + rr < minX || idxX[m] - rr > maxX || idxZ[m] + rr < minZ || idxZ[m] - rr > maxZ) continue;
+            blockSightLines(lines.fromX, lines.fromZ, lines.toX, lines.toZ, n, idxX[m], idxZ[m], rr, lines.blocked);
+        }
+    };
+
+    // A bucket visited twice only sets the same flags again.
+    const float reach = clearance + idxMaxRadius;
+    const int x0 = indexCellOf(minX - reach), x1 = indexCellOf(maxX + reach);
+    const int z0 = indexCellOf(minZ - reach), z1 = indexCellOf(maxZ + reach);
+    if (idxX.size() <= kLinearScanMax ||
+        static_cast<uint64_t>(x1 - x0 + 1) * static_cast<uint64_t>(z1 - z0 + 1) > idxBucketMask + 1u) {
+        visit(0, static_cast<uint32_t>(idxX.size()));
+    } else {
+        for (int cz = z0; cz <= z1; ++cz) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                const uint32_t b = indexBucketOf(cx, cz, idxBucketMask);
+                visit(idxBucketStart[b], idxBucketStart[b + 1]);
+            }
+        }
+    }
+
+    size_t blockedCount = 0;
+    for (size_t k = 0; k < n; ++k) blockedCount += lines.blocked[k];
+    return blockedCount;
+}
+
+void MountainManager::rebuildIndex() {
+    size_t count = 0;
+    idxMaxRadius = 0.0f;
     for (const auto& m : mountains) {
         if (!m.active) continue;
-        float rr = r + m.radius;
-        if (dist2XZ(p, m.position) < rr * rr) {
-            return true;
+        ++count;
+        idxMaxRadius = std::max(idxMaxRadius, m.radius);
+    }
+
+    uint32_t buckets = 16;
+    while (buckets < count * 2) buckets <<= 1;
+    idxBucketMask = buckets - 1;
+    idxBucketStart.assign(buckets + 1, 0);
+    for (const auto& m : mountains) {
+        if (m.active) ++idxBucketStart[indexBucketOf(indexCellOf(m.position.x), indexCellOf(m.position.z), idxBucketMask) + 1];
+    }
+    for (uint32_t b = 0; b < buckets; ++b) idxBucketStart[b + 1] += idxBucketStart[b];
+
+    // Scatter using idxBucketStart[b] as the write cursor, then shift the table back.
+    idxX.resize(count);
+    idxZ.resize(count);
+    idxRadius.resize(count);
+    for (const auto& m : mountains) {
+        if (!m.active) continue;
+        const uint32_t slot = idxBucketStart[indexBucketOf(indexCellOf(m.position.x), indexCellOf(m.position.z), idxBucketMask)]++;
+        idxX[slot] = m.position.x;
+        idxZ[slot] = m.position.z;
+        idxRadius[slot] = m.radius;
+    }
+    for (uint32_t b = buckets; b > 0; --b) idxBucketStart[b] = idxBucketStart[b - 1];
+    idxBucketStart[0] = 0;
+}
+
+// Earliest contact of the moving circle with any of the n circles, or best if none comes
+// sooner. 0 if the circle already overlaps one.
+static float earliestImpact(const float* xs, const float* zs, const float* rs, size_t n,
+                            float ox, float oz, float vx, float vz, float r, float best) {
+    const float a = vx*vx + vz*vz;
+    for (size_t i = 0; i < n; ++i) {
+        const float rr = r + rs[i];
+        const float dx = ox - xs[i];
+        const float dz = oz - zs[i];
+        const float c  = dx*dx + dz*dz - rr*rr;
+        if (c < 0.0f) return 0.0f;          // already inside
+        if (a <= 0.0f) continue;
+        const float b = dx*vx + dz*vz;       // half the linear term
+        if (b >= 0.0f) continue;             // moving away
+        const float disc = b*b - a*c;
+        if (disc < 0.0f) continue;           // passes beside it
+        const float t = (-b - std::sqrt(disc)) / a;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+// Only mountains whose center lies within r + idxMaxRadius of the path up to maxTime can
+// be touched, so the cells under the path's box are enough. The earliest time doesn't
+// depend on the order mountains are visited, and a bucket visited twice changes nothing.
+float MountainManager::TimeOfImpact(const glm::vec3& o, const glm::vec3& v, float r, float maxTime) const {
+    const size_t count = idxX.size();
+    const float endX = o.x + v.x * maxTime, endZ = o.z + v.z * maxTime;
+    const float reach = r + idxMaxRadius;
+    if (count <= kLinearScanMax || !std::isfinite(endX) || !std::isfinite(endZ))
+        return earliestImpact(idxX.data(), idxZ.data(), idxRadius.data(), count, o.x, o.z, v.x, v.z, r, maxTime);
+    const int x0 = indexCellOf(std::min(o.x, endX) - reach), x1 = indexCellOf(std::max(o.x, endX) + reach);
+    const int z0 = indexCellOf(std::min(o.z, endZ) - reach), z1 = indexCellOf(std::max(o.z, endZ) + reach);
+    if (static_cast<uint64_t>(x1 - x0 + 1) * static_cast<uint64_t>(z1 - z0 + 1) > idxBucketMask + 1u)
+        return earliestImpact(idxX.data(), idxZ.data(), idxRadius.data(), count, o.x, o.z, v.x, v.z, r, maxTime);
+
+    float best = maxTime;
+    for (int cz = z0; cz <= z1; ++cz) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            const uint32_t b = indexBucketOf(cx, cz, idxBucketMask);
+            const uint32_t begin = idxBucketStart[b], end = idxBucketStart[b + 1];
+            best = earliestImpact(idxX.data() + begin, idxZ.data() + begin, idxRadius.data() + begin, end - begin,
+                                  o.x, o.z, v.x, v.z, r, best);
+            if (best <= 0.0f) return 0.0f;
         }
     }
-    return false;
+    return best;
 }
 
 // Spawning
 void MountainManager::SpawnMountain(const glm::vec3& playerPosition) {
     Mountain m;
     m.active = true;
-    m.textureIndex = std::min(kNumMountainTextures - 1, static_cast<int>(frand01() * kNumMountainTextures));
+    m.textureIndex = rng->RangeInt(0, kNumMountainTextures);
 
-    float s = frandRange(kScaleMin, kScaleMax);
+    float s = rng->Range(kScaleMin, kScaleMax);
     m.scale  = glm::vec3(s);
     m.radius = kMountainMeshBaseRadius * s; 
 
     for (int t = 0; t < kPlaceTries; ++t) {
-        float r   = frandRange(SPAWN_RADIUS_MIN_MOUNTAIN, SPAWN_RADIUS_MAX_MOUNTAIN);
-        glm::vec2 dir = randDir2();
+        float r   = rng->Range(SPAWN_RADIUS_MIN_MOUNTAIN, SPAWN_RADIUS_MAX_MOUNTAIN);
+        glm::vec2 dir = randDir2(*rng);
         glm::vec3 pos(playerPosition.x + dir.x * r,
                       kWaterLevelY,
                       playerPosition.z + dir.y * r);
@@ -101,29 +376,33 @@ void MountainManager::SpawnMountain(const glm::vec3& playerPosition) {
         if (!checkCollision(pos, m.radius * 0.9f)) { 
             m.position = pos;
             mountains.push_back(m);
+            ++generation;
+            rebuildIndex();
             return;
         }
     }
 }
 
 void MountainManager::RepositionFarMountain(Mountain& m, const glm::vec3& playerPosition) {
-    m.textureIndex = std::min(kNumMountainTextures - 1, static_cast<int>(frand01() * kNumMountainTextures));
-    float s = frandRange(kScaleMin, kScaleMax);
+    ++generation; // the radius changes even if no new spot is found
+    m.textureIndex = rng->RangeInt(0, kNumMountainTextures);
+    float s = rng->Range(kScaleMin, kScaleMax);
     m.scale  = glm::vec3(s);
     m.radius = kMountainMeshBaseRadius * s;
 
 
     for (int t = 0; t < kPlaceTries; ++t) {
-        float r   = frandRange(kRespawnAheadMin, kRespawnAheadMax);
-        glm::vec2 dir = randDir2();
+        float r   = rng->Range(kRespawnAheadMin, kRespawnAheadMax);
+        glm::vec2 dir = randDir2(*rng);
         glm::vec3 pos(playerPosition.x + dir.x * r,
                       kWaterLevelY,
                       playerPosition.z + dir.y * r);
 
         if (!checkCollision(pos, m.radius * 0.9f)) {
             m.position = pos;
-            return;
+            break;
         }
     }
     // If no valid spot found, keep current position and try again next update.
+    rebuildIndex();
 }
@@ -0,0 +1,227 @@
+#include "NavField.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+bool sameFootprint(const Mountain& a, const Mountain& b) {
+    return a.position.x == b.position.x && a.position.z == b.position.z && a.radius == b.radius;
+}
+
+} // namespace
+
+NavField::NavField(int cellsPerSide, float size, float boatRadius)
+    : cellSize(size), invCellSize(1.0f / size), clearance(boatRadius) {
+    n = 1;
+    shift = 0;
+    while (n < cellsPerSide) { n <<= 1; ++shift; }
+    ringMask = static_cast<uint32_t>(n - 1);
+    const size_t cells = static_cast<size_t>(n) * n;
+    blocked.assign(cells, 0);
+    dist.assign(cells, kUnreachable);
+    accepted.assign(cells, 0);
+}
+
+void NavField::Init() {
+    valid = false;
+    stamped.clear();
+    std::fill(dist.begin(), dist.end(), kUnreachable);
+    stats = NavFieldStats();
+}
+
+bool NavField::Refresh(const glm::vec3& playerPosition, const MountainManager& mountains) {
+    const int ox = cellOf(playerPosition.x) - n / 2;
+    const int oz = cellOf(playerPosition.z) - n / 2;
+    bool changed = false;
+
+    if (!valid || std::abs(ox - originX) >= n || std::abs(oz - originZ) >= n) {
+        originX = ox;
+        originZ = oz;
+        stamped = mountains.GetMountains();
+        mountainGeneration = mountains.GetGeneration();
+        rasterize(CellRect{ ox, oz, ox + n, oz + n });
+        ++stats.fullRebuilds;
+        valid = true;
+        changed = true;
+    } else {
+        // Scroll: only the strips entering the window need rasterizing; the ring slots they
+        // land in still hold the strips that just left.
+        if (ox != originX || oz != originZ) {
+            const int oldX = originX, oldZ = originZ;
+            originX = ox;
+            originZ = oz;
+            if (ox > oldX)      rasterize(CellRect{ oldX + n, oz, ox + n, oz + n });
+            else if (ox < oldX) rasterize(CellRect{ ox, oz, oldX, oz + n });
+            if (oz > oldZ)      rasterize(CellRect{ ox, oldZ + n, ox + n, oz + n });
+            else if (oz < oldZ) rasterize(CellRect{ ox, oz, ox + n, oldZ });
+            changed = true;
+        }
+        if (mountains.GetGeneration() != mountainGeneration) {
+            mountainGeneration = mountains.GetGeneration();
+            changed |= restampChangedMountains(mountains.GetMountains());
+        }
+    }
+
+    if (changed) solve();
+    return changed;
+}
+
+NavField::CellRect NavField::footprint(const Mountain& m) const {
+    const float reach = m.radius + clearance + cellSize * 0.70710678f;
+    return CellRect{ cellOf(m.position.x - reach), cellOf(m.position.z - reach),
+                     cellOf(m.position.x + reach) + 1, cellOf(m.position.z + reach) + 1 };
+}
+
+// Clears r (clipped to the window) and stamps every mountain overlapping it. A cell is
+// blocked when its center is within radius + clearance + half a cell diagonal of a mountain,
+// so nowhere in an open cell can a boat touch one.
+void NavField::rasterize(CellRect r) {
+    r.x0 = std::max(r.x0, originX);
+    r.z0 = std::max(r.z0, originZ);
+    r.x1 = std::min(r.x1, originX + n);
+    r.z1 = std::min(r.z1, originZ + n);
+    if (r.x0 >= r.x1 || r.z0 >= r.z1) return;
+
+    for (int wz = r.z0; wz < r.z1; ++wz)
+        for (int wx = r.x0; wx < r.x1; ++wx) blocked[ringIndex(wx, wz)] = 0;
+    stats.cellsRasterized += static_cast<uint64_t>(r.x1 - r.x0) * static_cast<uint64_t>(r.z1 - r.z0);
+
+    for (const Mountain& m : stamped) {
+        if (!m.active) continue;
+        const CellRect f = footprint(m);
+        const int x0 = std::max(f.x0, r.x0), x1 = std::min(f.x1, r.x1);
+        const int z0 = std::max(f.z0, r.z0), z1 = std::min(f.z1, r.z1);
+        const float reach = m.radius + clearance + cellSize * 0.70710678f;
+        for (int wz = z0; wz < z1; ++wz) {
+            const float dz = (static_cast<float>(wz) + 0.5f) * cellSize - m.position.z;
+            for (int wx = x0; wx < x1; ++wx) {
+                const float dx = (static_cast<float>(wx) + 0.5f) * cellSize - m.position.x;
+                if (dx * dx + dz * dz < reach * reach) blocked[ringIndex(wx, wz)] = 1;
+            }
+        }
+    }
+}
+
+// Re-rasterizes the old and new footprint of every mountain that was added, removed or
+// moved since the last stamp. Returns false if none was.
+bool NavField::restampChangedMountains(const std::vector<Mountain>& current) {
+    dirtyRects.clear();
+    const size_t count = std::max(stamped.size(), current.size());
+    for (size_t k = 0; k < count; ++k) {
+        const Mountain* before = (k < stamped.size() && stamped[k].active) ? &stamped[k] : nullptr;
+        const Mountain* after  = (k < current.size() && current[k].active) ? &current[k] : nullptr;
+        if (!before && !after) continue;
+        if (before && after && sameFootprint(*before, *after)) continue;
+        if (before) dirtyRects.push_back(footprint(*before));
+        if (after)  dirtyRects.push_back(footprint(*after));
+    }
+    stamped = current;
+    for (const CellRect& r : dirtyRects) rasterize(r);
+    return !dirtyRects.empty();
+}
+
+// Fast marching from the player's cell over the open cells (4-connected). Each cell takes
+// the eikonal update from its accepted neighbors, which follows the straight-line distance
+// in open water far better than summing 8-way grid steps would.
+void NavField::solve() {
+    std::fill(dist.begin(), dist.end(), kUnreachable);
+    std::fill(accepted.begin(), accepted.end(), 0);
+    heap.clear();
+    ++stats.solves;
+
+    const float h = cellSize;
+    const auto fartherFirst = [](const HeapEntry& a, const HeapEntry& b) { return a.distance > b.distance; }; // min-heap
+    auto known = [&](int x, int z) {
+        if (x < 0 || z < 0 || x >= n || z >= n) return kUnreachable;
+        const size_t c = static_cast<size_t>(z) * n + x;
+        return accepted[c] ? dist[c] : kUnreachable;
+    };
+
+    // The player's cell is the source even if the clearance margin covers it.
+    const uint32_t source = static_cast<uint32_t>((n / 2) * n + n / 2);
+    dist[source] = 0.0f;
+    heap.push_back(HeapEntry{ 0.0f, source });
+
+    static constexpr int kStepX[4] = { -1, 1, 0, 0 };
+    static constexpr int kStepZ[4] = { 0, 0, -1, 1 };
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), fartherFirst);
+        const HeapEntry top = heap.back();
+        heap.pop_back();
+        if (accepted[top.cell]) continue;
+        accepted[top.cell] = 1;
+
+        const int cx = static_cast<int>(top.cell) % n;
+        const int cz = static_cast<int>(top.cell) / n;
+        for (int k = 0; k < 4; ++k) {
+            const int x = cx + kStepX[k], z = cz + kStepZ[k];
+            if (x < 0 || z < 0 || x >= n || z >= n) continue;
+            const size_t c = static_cast<size_t>(z) * n + x;
+            if (accepted[c] || blocked[ringIndex(originX + x, originZ + z)]) continue;
+
+            float a = std::min(known(x - 1, z), known(x + 1, z));
+            float b = std::min(known(x, z - 1), known(x, z + 1));
+            if (a > b) std::swap(a, b);
+            const float t = (b - a >= h) ? a + h : 0.5f * (a + b + std::sqrt(2.0f * h * h - (b - a) * (b - a)));
+            if (t < dist[c]) {
+                dist[c] = t;
+                heap.push_back(HeapEntry{ t, static_cast<uint32_t>(c) });
+                std::push_heap(heap.begin(), heap.end(), fartherFirst);
+            }
+        }
+    }
+}
+
+float NavField::solvedAt(int x, int z) const {
+    if (x < 0 || z < 0 || x >= n || z >= n) return kUnreachable;
+    if (blocked[ringIndex(originX + x, originZ + z)]) return kUnreachable;
+    return dist[static_cast<size_t>(z) * n + x];
+}
+
+glm::vec3 NavField::CellCenter(int x, int z) const {
+    return glm::vec3((static_cast<float>(originX + x) + 0.5f) * cellSize, 0.0f,
+                     (static_cast<float>(originZ + z) + 0.5f) * cellSize);
+}
+
+float NavField::PathDistance(const glm::vec3& position) const {
+    if (!valid) return kUnreachable;
+    return solvedAt(cellOf(position.x) - originX, cellOf(position.z) - originZ);
+}
+
+bool NavField::Sample(const glm::vec3& position, glm::vec2& direction) const {
+    if (!valid) return false;
+    const int x = cellOf(position.x) - originX;
+    const int z = cellOf(position.z) - originZ;
+    if (x < 0 || z < 0 || x >= n || z >= n) return false;
+    if (x == n / 2 && z == n / 2) return false;
+
+    const float here = solvedAt(x, z);
+    if (here == kUnreachable) {
+        // Inside the margin around a mountain: head for the open neighbor nearest the player.
+        float best = kUnreachable;
+        int bx = 0, bz = 0;
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                const float d = solvedAt(x + dx, z + dz);
+                if (d < best) { best = d; bx = x + dx; bz = z + dz; }
+            }
+        }
+        if (best == kUnreachable) return false;
+        const glm::vec3 to = CellCenter(bx, bz) - position;
+        const float len = std::sqrt(to.x * to.x + to.z * to.z);
+        if (len <= 0.0f) return false;
+        direction = glm::vec2(to.x / len, to.z / len);
+        return true;
+    }
+
+    // Upwind differences: along each axis, step toward the lower neighbor if there is one.
+    const float left = solvedAt(x - 1, z), right = solvedAt(x + 1, z);
+    const float down = solvedAt(x, z - 1), up    = solvedAt(x, z + 1);
+    float gx = 0.0f, gz = 0.0f;
+    if (std::min(left, right) < here) gx = (left < right) ? here - left : right - here;
+    if (std::min(down, up) < here)    gz = (down < up)    ? here - down : up - here;
+    const float len = std::sqrt(gx * gx + gz * gz);
+    if (len <= 0.0f) return false;
+    direction = glm::vec2(-gx / len, -gz / len);
+    return true;
+}
@@ -1,17 +1,28 @@
 #include "Player.h"
 #include "ProjectileManager.h"
 #include "MountainManager.h"
-#include <GLFW/glfw3.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 Player::Player() { Reset(); }
 
-void Player::Reset() {
+static constexpr float kSpawnGraceSeconds = 3.0f;
+static constexpr float kHitGraceSeconds   = 1.5f;
+static constexpr float kCrazySpeedScale   = 1.75f;
+// Same hull size and response as the enemy boats.
+static constexpr BuoyancyParams kPlayerBuoyancy{ 5.0f, 2.0f, 16.0f, 4.8f };
+
+void Player::Reset(float tickLength) {
     position     = glm::vec3(30.0f, -1.0f, 30.0f);
     velocity     = glm::vec3(0.0f);
     rotation     = 0.0f;
     shipFront    = glm::vec3(0.0f, 0.0f, 1.0f);
+    prevPosition = position;
+    prevRotation = rotation;
+    heave = pitch = roll = 0.0f;
+    heaveRate = pitchRate = rollRate = 0.0f;
 
     baseSpeed    = 8.0f;
     baseBoost    = 16.0f;
@@ -20,35 +31,55 @@ void Player::Reset() {
 
     maxHealth    = 300;
     health       = maxHealth;
-    shootCooldown= 0.0f;
-    gracePeriod  = 3.0f;
     boatSkinIndex= 0;
+
+    tick         = 0;
+    tickSeconds  = tickLength;
+    timers.Reset(0);
+    shotTimer    = TimerHandle{};
+    graceTimer   = timers.Schedule(TicksFor(kSpawnGraceSeconds, tickSeconds), 0);
 }
 
 void Player::SetPhysicsMode(bool crazyOn) {
     if (crazyOn) {
-        speed = baseSpeed * 1.75f;
-        boostSpeed = baseBoost * 1.75f;
+        speed = baseSpeed * kCrazySpeedScale;
+        boostSpeed = baseBoost * kCrazySpeedScale;
     } else {
         speed      = baseSpeed;
         boostSpeed = baseBoost;
     }
 }
 
+float Player::GetTopSpeed() const {
+    return std::max(baseSpeed, baseBoost) * kCrazySpeedScale;
+}
+
 void Player::AlignToWater(float waterY) {
     if (boatSkinIndex == BoatSkinId::GOING_MERRY) {
         position.y = waterY + 0.25f;
     }
 }
 
+void Player::Float(float time, float dt) {
+    const float yaw = glm::radians(rotation);
+    float bowX = std::sin(yaw), bowZ = std::cos(yaw);
+    if (boatSkinIndex == BoatSkinId::GOING_MERRY) {
+        bowX = std::cos(yaw);
+        bowZ = -std::sin(yaw);
+    }
+    buoyancy.Float(BuoyancyArrays{ &position.x, &position.z, &bowX, &bowZ, &heave, &pitch, &roll,
+                                   &heaveRate, &pitchRate, &rollRate, 1 },
+                   kPlayerBuoyancy, time, dt);
+}
+
+// The timers only flag expiry; Pending is checked where it matters.
 void Player::Update(float dt) {
-    if (shootCooldown > 0.0f) shootCooldown -= dt;
-    if (gracePeriod   > 0.0f) gracePeriod   -= dt;
+    tickSeconds = dt;
+    timers.Advance(++tick, [](uint64_t) {});
 }
 
-void Player::ProcessGameInput(GLFWwindow* window, float dt, ProjectileManager& projectileManager, MountainManager& mountainManager) {
-    const bool boosting = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS ||
-                          glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS;
+void Player::ProcessGameInput(const InputState& input, float dt, ProjectileManager& projectileManager, MountainManager& mountainManager) {
+    const bool boosting = input.IsDown(BTN_BOOST);
     const float currentSpeed = boosting ? boostSpeed : speed;
 
     glm::vec3 proposed = position;
@@ -57,18 +88,18 @@ void Player::ProcessGameInput(GLFWwindow* window, float dt, ProjectileManager& p
     if (boatSkinIndex == BoatSkinId::GOING_MERRY) {
         forward = glm::vec3(cos(glm::radians(rotation)), 0.0f, -sin(glm::radians(rotation)));
     }
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
+    if (input.IsDown(BTN_FORWARD)) {
         proposed += forward * currentSpeed * dt;
     }
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
+    if (input.IsDown(BTN_BACK)) {
         proposed -= forward * (currentSpeed * 0.7f * dt);
     }
     if (!mountainManager.checkCollision(proposed, 1.0f)) {
         position = proposed;
     }
 
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) rotation += 90.0f * dt;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) rotation -= 90.0f * dt;
+    if (input.IsDown(BTN_TURN_LEFT)) rotation += 90.0f * dt;
+    if (input.IsDown(BTN_TURN_RIGHT)) rotation -= 90.0f * dt;
 
     const float shipYawRadians = glm::radians(rotation);
     if (boatSkinIndex == BoatSkinId::GOING_MERRY) {
@@ -76,7 +107,7 @@ void Player::ProcessGameInput(GLFWwindow* window, float dt, ProjectileManager& p
     } else {
         shipFront = glm::normalize(glm::vec3(sin(shipYawRadians), 0.0f, cos(shipYawRadians)));
     }
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && shootCooldown <= 0.0f) {
+    if (input.IsDown(BTN_FIRE) && !timers.Pending(shotTimer)) {
         if (boatSkinIndex == BoatSkinId::GOING_MERRY) {
             glm::mat4 shipTransform = glm::mat4(1.0f);
             shipTransform = glm::translate(shipTransform, position);
@@ -89,27 +120,33 @@ void Player::ProcessGameInput(GLFWwindow* window, float dt, ProjectileManager& p
             glm::vec3 spawnPos = actualShipCenter + shipFront * 2.0f + modelUp * 0.2f;
             glm::vec3 vel      = shipFront * 20.0f;
             projectileManager.AddProjectile(spawnPos, vel, true, false);
-            shootCooldown = 0.5f;
+            shotTimer = timers.Schedule(tick + TicksFor(0.5f, dt), 0);
         } else {
             float yOffset = 0.0f;
             if (boatSkinIndex == BoatSkinId::BIG_MOM) yOffset = -0.5f;
             glm::vec3 muzzle = position + glm::vec3(sin(glm::radians(rotation)) * 2.0f, yOffset, cos(glm::radians(rotation)) * 2.0f);
             glm::vec3 vel    = glm::vec3(sin(glm::radians(rotation)) * 20.0f, 0.0f, cos(glm::radians(rotation)) * 20.0f);
             projectileManager.AddProjectile(muzzle, vel, true);
-            shootCooldown = 0.1f;
+            shotTimer = timers.Schedule(tick + TicksFor(0.1f, dt), 0);
         }
     }
 }
 
 void Player::TakeDamage(int damage) {
-    if (gracePeriod > 0.0f) {
-        std::cout << "Player is invincible! No damage taken.\n";
+    if (timers.Pending(graceTimer)) {
+        if (verbose) std::cout << "Player is invincible! No damage taken.\n";
         return;
     }
     health -= damage;
     if (health < 0) health = 0;
-    gracePeriod = 1.5f;
-    std::cout << "Player took " << damage << " damage. Health: " << health << "\n";
+    graceTimer = timers.Schedule(tick + TicksFor(kHitGraceSeconds, tickSeconds), 0);
+    if (verbose) std::cout << "Player took " << damage << " damage. Health: " << health << "\n";
+}
+
+float Player::GetInterpolatedRotation(float alpha) const {
+    // Take the short way round when AdjustRotation wrapped between ticks.
+    float delta = std::fmod(rotation - prevRotation + 540.0f, 360.0f) - 180.0f;
+    return prevRotation + delta * alpha;
 }
 
 void Player::AdjustRotation(float offset) {
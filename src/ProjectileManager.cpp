@@ -1,50 +1,252 @@
 #include "ProjectileManager.h"
 #include "MountainManager.h"
 #include "ModelManager.h"
-#include <iostream>
-
-ProjectileManager::ProjectileManager() {}
-
-void ProjectileManager::Update(float dt, MountainManager& mountainManager) {
-    for (auto it = projectiles.begin(); it != projectiles.end();) {
-        it->position += it->velocity * dt;
-        it->lifetime -= dt;
-        
-        if (!it->isPlayerOwned) {
-            it->smokeTimer += dt;
-            if (it->smokeTimer >= 0.1f) {
-                it->smokeTrail.push_back(it->position);
-                it->smokeTimer = 0.0f;
-                if (it->smokeTrail.size() > 8) {
-                    it->smokeTrail.erase(it->smokeTrail.begin());
-                }
-            }
-        }
-        
-        if (it->lifetime <= 0.0f || mountainManager.checkCollision(it->position, 0.1f)) {
-            it = projectiles.erase(it);
-        } else {
-            ++it;
+#include "Ballistics.h"
+#include <algorithm>
+#include <cmath>
+
+ProjectileManager::ProjectileManager() {
+    Init(512);
+}
+
+static constexpr float kProjectileRadius = 0.1f;
+static constexpr float kProjectileLifetime = 5.0f;
+static constexpr float kSmokeSeconds = 0.1f; // between puffs behind an enemy shot
+static constexpr float kCheckSlack = 0.5f;    // of a hit check's reach, for rounding and the target's bobbing
+
+// A timer's tag packs the projectile's handle (generation in the high half, slot shifted up
+// one) with a low bit saying which of its timers it is.
+enum : uint64_t { kExpiryTimer = 0, kCheckTimer = 1 };
+
+static uint64_t timerTag(ProjectileHandle h, uint64_t kind) {
+    return (static_cast<uint64_t>(h.generation) << 32) | (static_cast<uint64_t>(h.slot) << 1) | kind;
+}
+
+template <typename T>
+static void swapPop(std::vector<T>& v, size_t i) {
+    v[i] = v.back();
+    v.pop_back();
+}
+
+// ProjectileStore
+void ProjectileStore::Reset(size_t n) {
+    capacity = n;
+    origin.clear();        origin.reserve(n);
+    velocity.clear();      velocity.reserve(n);
+    spawnTime.clear();     spawnTime.reserve(n);
+    ballistic.clear();     ballistic.reserve(n);
+    lifetime.clear();      lifetime.reserve(n);
+    playerOwned.clear();   playerOwned.reserve(n);
+    expiryTimer.clear();   expiryTimer.reserve(n);
+    checkTimer.clear();    checkTimer.reserve(n);
+    expiresAt.clear();     expiresAt.reserve(n);
+    scheduled.clear();     scheduled.reserve(n);
+    slot.clear();          slot.reserve(n);
+
+    // Generations only ever go up, so no handle from before the reset can match again.
+    for (auto& g : slotGeneration) ++g;
+    if (slotGeneration.size() < n) slotGeneration.resize(n, 1);
+    slotDense.assign(n, 0);
+    freeSlots.resize(n);
+    for (size_t k = 0; k < n; ++k) freeSlots[k] = static_cast<uint32_t>(n - 1 - k);
+}
+
+ProjectileHandle ProjectileStore::Push(const glm::vec3& pos, const glm::vec3& vel, bool isPlayerOwned) {
+    if (freeSlots.empty()) {
+        ++dropped;
+        return ProjectileHandle{};
+    }
+    const uint32_t s = freeSlots.back();
+    freeSlots.pop_back();
+    slotDense[s] = static_cast<uint32_t>(origin.size());
+
+    origin.push_back(pos);
+    velocity.push_back(vel);
+    spawnTime.push_back(0.0);
+    ballistic.push_back(0);
+    lifetime.push_back(kProjectileLifetime);
+    playerOwned.push_back(isPlayerOwned ? 1 : 0);
+    expiryTimer.push_back(TimerHandle{});
+    checkTimer.push_back(TimerHandle{});
+    expiresAt.push_back(0.0);
+    scheduled.push_back(0);
+    slot.push_back(s);
+
+    highWater = std::max(highWater, origin.size());
+    return ProjectileHandle{ s, slotGeneration[s] };
+}
+
+void ProjectileStore::SwapRemove(size_t i) {
+    const uint32_t s = slot[i];
+    ++slotGeneration[s];
+    freeSlots.push_back(s);
+    slotDense[slot.back()] = static_cast<uint32_t>(i);
+
+    swapPop(origin, i);
+    swapPop(velocity, i);
+    swapPop(spawnTime, i);
+    swapPop(ballistic, i);
+    swapPop(lifetime, i);
+    swapPop(playerOwned, i);
+    swapPop(expiryTimer, i);
+    swapPop(checkTimer, i);
+    swapPop(expiresAt, i);
+    swapPop(scheduled, i);
+    swapPop(slot, i);
+}
+
+long long ProjectileStore::IndexOf(ProjectileHandle h) const {
+    if (h.slot >= capacity || slotGeneration[h.slot] != h.generation) return -1;
+    return slotDense[h.slot];
+}
+
+// ProjectileManager
+
+// A shot's path is fixed when it is fired: a straight line, or for a ballistic shot an arc
+// whose XZ track is still a straight line at constant speed. So the moment it hits a
+// mountain or (ballistic) falls into the water is known up front. Expiry is a timer set
+// from that schedule instead of a per-frame test, and only moved when the mountain set
+// changes. It fires at the first Integrate whose clock has reached the impact.
+void ProjectileManager::schedule(size_t i, const MountainManager& mountainManager) {
+    double endsAt = store.spawnTime[i] + store.lifetime[i];
+    if (store.ballistic[i])
+        endsAt = std::min(endsAt, store.spawnTime[i] + TimeToFall(store.origin[i].y, store.velocity[i].y, kSeaLevel));
+    const float remaining = static_cast<float>(std::max(endsAt - clock, 0.0));
+    // Mountains are tested in XZ only, where both kinds of shot move at a constant velocity.
+    const float toi = mountainManager.TimeOfImpact(Position(i), store.velocity[i], kProjectileRadius, remaining);
+    store.expiresAt[i] = clock + toi;
+    store.scheduled[i] = 1;
+    const uint32_t ticks = std::max(1u, static_cast<uint32_t>(std::ceil(toi / tickSeconds)));
+    timers.Cancel(store.expiryTimer[i]);
+    store.expiryTimer[i] = timers.Schedule(tick + ticks, timerTag(store.HandleAt(i), kExpiryTimer));
+}
+
+void ProjectileManager::rescheduleAll(const MountainManager& mountainManager) {
+    for (size_t i = 0; i < store.Size(); ++i) schedule(i, mountainManager);
+    scheduledGeneration = mountainManager.GetGeneration();
+}
+
+void ProjectileManager::Schedule(float dt, const MountainManager& mountainManager) {
+    tickSeconds = dt;
+    if (mountainManager.GetGeneration() != scheduledGeneration) {
+        rescheduleAll(mountainManager);
+        return;
+    }
+    for (size_t i = 0; i < store.Size(); ++i) {
+        if (!store.scheduled[i]) schedule(i, mountainManager);
+    }
+}
+
+void ProjectileManager::Integrate(float dt) {
+    clock += dt;
+    tickSeconds = dt;
+    timers.Advance(++tick, [this](uint64_t tag) { onTimer(tag); });
+}
+
+void ProjectileManager::onTimer(uint64_t tag) {
+    const ProjectileHandle h{ static_cast<uint32_t>(tag) >> 1, static_cast<uint32_t>(tag >> 32) };
+    const long long i = store.IndexOf(h);
+    if (i < 0) return;
+    if ((tag & 1) == kCheckTimer) checkDue.push_back(h);
+    else                          Remove(static_cast<size_t>(i));
+}
+
+glm::vec3 ProjectileManager::PositionAt(size_t i, double time) const {
+    const float t = static_cast<float>(std::max(time - store.spawnTime[i], 0.0));
+    if (store.ballistic[i]) return BallisticPosition(store.origin[i], store.velocity[i], t);
+    return store.origin[i] + store.velocity[i] * t;
+}
+
+// A puff is left every kSmokeSeconds (in whole ticks) from launch, so the trail follows
+// from the shot's age without being recorded.
+SmokeRing ProjectileManager::SmokeTrail(size_t i) const {
+    SmokeRing trail;
+    if (store.playerOwned[i]) return trail;
+    const double every = TicksFor(kSmokeSeconds, tickSeconds) * static_cast<double>(tickSeconds);
+    const long long puffs = static_cast<long long>((clock - store.spawnTime[i]) / every + 1e-6);
+    for (long long k = std::max(1LL, puffs - SmokeRing::kSlots + 1); k <= puffs; ++k)
+        trail.Push(PositionAt(i, store.spawnTime[i] + k * every));
+    return trail;
+}
+
+// Fastest projectile i moves at any point in its flight: a falling shell is quickest when
+// it reaches the water, give or take the tick it may spend below before expiring.
+float ProjectileManager::maxSpeed(size_t i) const {
+    const glm::vec3& v = store.velocity[i];
+    if (!store.ballistic[i]) return glm::length(v);
+    const float drop = std::max(store.origin[i].y - kSeaLevel, 0.0f);
+    const float fall = std::sqrt(v.y * v.y + 2.0f * kGravity * drop) + kGravity * tickSeconds;
+    const float vy = std::max(std::fabs(v.y), fall);
+    return std::sqrt(v.x * v.x + v.z * v.z + vy * vy);
+}
+
+// A shot that is gap away from the target can't be within radius before both have covered
+// it, so the next check waits that many ticks at their top speeds.
+void ProjectileManager::CollectHitsOnTarget(const glm::vec3& target, float radius, float targetSpeed,
+                                            std::vector<uint32_t>& hits) {
+    hits.clear();
+    for (const ProjectileHandle& h : checkDue) {
+        const long long found = store.IndexOf(h);
+        if (found < 0) continue;
+        const size_t i = static_cast<size_t>(found);
+        if (SegmentDistance2(PreviousPosition(i), Position(i), target) < radius * radius) {
+            hits.push_back(static_cast<uint32_t>(i));
+            continue;
         }
+        const glm::vec3 d = Position(i) - target;
+        const float gap = std::sqrt(glm::dot(d, d)) - radius - kCheckSlack;
+        const float perTick = (maxSpeed(i) + targetSpeed) * tickSeconds;
+        const uint32_t wait = (gap > perTick) ? static_cast<uint32_t>(std::min(gap / perTick, 1e6f)) : 1u;
+        store.checkTimer[i] = timers.Schedule(tick + wait, timerTag(h, kCheckTimer));
     }
+    checkDue.clear();
+    std::sort(hits.begin(), hits.end());
+}
+
+void ProjectileManager::CheckAgainNextTick(size_t i) {
+    timers.Cancel(store.checkTimer[i]);
+    store.checkTimer[i] = timers.Schedule(tick + 1, timerTag(store.HandleAt(i), kCheckTimer));
+}
+
+void ProjectileManager::Remove(size_t i) {
+    timers.Cancel(store.expiryTimer[i]);
+    timers.Cancel(store.checkTimer[i]);
+    store.SwapRemove(i);
+}
+
+void ProjectileManager::Init(size_t capacity) {
+    store.Reset(capacity);
+    timers.Reset(0);
+    checkDue.clear();
+    clock = 0.0;
+    tick = 0;
 }
 
-void ProjectileManager::AddProjectile(glm::vec3 pos, glm::vec3 vel, bool isPlayerOwned, bool clampToWater) {
+// Enemy shots get their first hit check in the tick they are fired.
+ProjectileHandle ProjectileManager::add(const glm::vec3& pos, const glm::vec3& vel, bool isPlayerOwned, bool isBallistic) {
+    const ProjectileHandle h = store.Push(pos, vel, isPlayerOwned);
+    if (h.IsNull()) return h;
+    store.spawnTime.back() = clock;
+    store.ballistic.back() = isBallistic ? 1 : 0;
+    if (!isPlayerOwned) checkDue.push_back(h);
+    return h;
+}
+
+ProjectileHandle ProjectileManager::AddProjectile(glm::vec3 pos, glm::vec3 vel, bool isPlayerOwned, bool clampToWater) {
     if (clampToWater) {
         const float WATER_LEVEL = -0.5f;
         pos.y = WATER_LEVEL + 0.05f;
     }
-    projectiles.emplace_back(pos, vel, isPlayerOwned);
+    return add(pos, vel, isPlayerOwned, false);
 }
 
-void ProjectileManager::Clear() {
-    projectiles.clear();
+ProjectileHandle ProjectileManager::AddBallistic(const glm::vec3& pos, const glm::vec3& vel, bool isPlayerOwned) {
+    return add(pos, vel, isPlayerOwned, true);
 }
 
 void ProjectileManager::DrawAll(unsigned int shader, ModelManager& modelManager) {
 
-    for (const auto& p : projectiles) {
-        modelManager.DrawCannonball(shader, p.position, 1.0f);
+    for (size_t i = 0; i < store.Size(); ++i) {
+        modelManager.DrawCannonball(shader, Position(i), 1.0f);
     }
 }
-
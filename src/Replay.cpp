@@ -0,0 +1,164 @@
+#include "Replay.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+static const char    kReplayMagic[4] = { 'B', 'E', 'R', 'P' };
+static const uint8_t kReplayVersion  = 1;
+
+// Helpers
+static void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+static uint64_t zigzag(int64_t v)   { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+static int64_t  unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+static bool getVarint(const std::vector<uint8_t>& in, size_t& pos, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        const uint8_t b = in[pos++];
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// ReplayRecorder
+void ReplayRecorder::Begin(const ReplayHeader& h) {
+    header      = h;
+    stream.clear();
+    runCmd      = TickCommand{};
+    lastButtons = 0;
+    runLength   = 0;
+    ticks       = 0;
+    recording   = true;
+}
+
+void ReplayRecorder::Record(const TickCommand& cmd) {
+    if (!recording) return;
+    if (runLength > 0 && cmd != runCmd) flushRun();
+    runCmd = cmd;
+    ++runLength;
+    ++ticks;
+}
+
+void ReplayRecorder::flushRun() {
+    if (runLength == 0) return;
+    putVarint(stream, runLength);
+    putVarint(stream, runCmd.buttons ^ lastButtons);
+    putVarint(stream, zigzag(runCmd.yawMilli));
+    lastButtons = runCmd.buttons;
+    runLength = 0;
+}
+
+bool ReplayRecorder::Save(const std::string& path, const ReplayDigest& digest) {
+    if (!recording) return false;
+    flushRun();
+    recording = false;
+
+    std::vector<uint8_t> bytes(std::begin(kReplayMagic), std::end(kReplayMagic));
+    bytes.push_back(kReplayVersion);
+    putVarint(bytes, header.seed);
+    bytes.push_back(header.difficulty);
+    bytes.push_back(header.boatSkin);
+    bytes.push_back(header.crazyPhysics);
+    putVarint(bytes, header.tickRate);
+    bytes.insert(bytes.end(), stream.begin(), stream.end());
+    putVarint(bytes, 0);
+    putVarint(bytes, digest.ticks);
+    putVarint(bytes, zigzag(digest.score));
+    putVarint(bytes, zigzag(digest.enemiesDestroyed));
+    putVarint(bytes, zigzag(digest.health));
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Replay: cannot write '" << path << "'\n";
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    std::cout << "Replay saved: " << path << " (" << digest.ticks << " ticks, " << bytes.size() << " bytes)\n";
+    return static_cast<bool>(file);
+}
+
+// ReplayPlayer
+bool ReplayPlayer::Load(const std::string& path) {
+    loaded = false;
+    runs.clear();
+    runLengths.clear();
+    runIndex = 0;
+    runRemaining = 0;
+    played = 0;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Replay: cannot open '" << path << "'\n";
+        return false;
+    }
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    size_t pos = 0;
+    uint64_t v = 0;
+    auto fail = [&](const char* what) {
+        std::cerr << "Replay: '" << path << "' is corrupt (" << what << ")\n";
+        return false;
+    };
+
+    if (bytes.size() < 5 || !std::equal(std::begin(kReplayMagic), std::end(kReplayMagic), bytes.begin()))
+        return fail("bad magic");
+    pos = 4;
+    if (bytes[pos++] != kReplayVersion) return fail("unsupported version");
+
+    if (!getVarint(bytes, pos, v)) return fail("header");
+    header.seed = static_cast<uint32_t>(v);
+    if (pos + 3 > bytes.size()) return fail("header");
+    header.difficulty   = bytes[pos++];
+    header.boatSkin     = bytes[pos++];
+    header.crazyPhysics = bytes[pos++];
+    if (!getVarint(bytes, pos, v)) return fail("header");
+    header.tickRate = static_cast<uint16_t>(v);
+
+    uint32_t buttons = 0;
+    for (;;) {
+        uint64_t length = 0, buttonDelta = 0, yaw = 0;
+        if (!getVarint(bytes, pos, length)) return fail("tick stream");
+        if (length == 0) break;
+        if (!getVarint(bytes, pos, buttonDelta) || !getVarint(bytes, pos, yaw)) return fail("tick stream");
+        buttons ^= static_cast<uint32_t>(buttonDelta);
+
+        TickCommand cmd;
+        cmd.buttons  = buttons;
+        cmd.yawMilli = static_cast<int32_t>(unzigzag(yaw));
+        runs.push_back(cmd);
+        runLengths.push_back(length);
+    }
+
+    uint64_t score = 0, destroyed = 0, health = 0;
+    if (!getVarint(bytes, pos, digest.ticks) || !getVarint(bytes, pos, score) ||
+        !getVarint(bytes, pos, destroyed) || !getVarint(bytes, pos, health))
+        return fail("digest");
+    digest.score            = static_cast<int32_t>(unzigzag(score));
+    digest.enemiesDestroyed = static_cast<int32_t>(unzigzag(destroyed));
+    digest.health           = static_cast<int32_t>(unzigzag(health));
+
+    runRemaining = runLengths.empty() ? 0 : runLengths[0];
+    loaded = true;
+    return true;
+}
+
+bool ReplayPlayer::Next(TickCommand& out) {
+    while (runIndex < runs.size() && runRemaining == 0) {
+        if (++runIndex < runs.size()) runRemaining = runLengths[runIndex];
+    }
+    if (runIndex >= runs.size()) return false;
+
+    out = runs[runIndex];
+    --runRemaining;
+    ++played;
+    return true;
+}
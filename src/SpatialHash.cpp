@@ -0,0 +1,29 @@
+#include "SpatialHash.h"
+
+SpatialHash::SpatialHash(float size) : cellSize(size), invCellSize(1.0f / size) {}
+
+void SpatialHash::Begin(size_t expectedCount) {
+    pending.clear();
+    if (pending.capacity() < expectedCount) pending.reserve(expectedCount);
+}
+
+void SpatialHash::Add(uint32_t id, const glm::vec3& p) {
+    pending.push_back(Entry{ p.x, p.z, cellOf(p.x), cellOf(p.z), id });
+}
+
+void SpatialHash::Finalize() {
+    // About two buckets per entry keeps unrelated cells from piling into one bucket.
+    uint32_t buckets = 64;
+    while (buckets < pending.size() * 2) buckets <<= 1;
+    bucketMask = buckets - 1;
+
+    bucketStart.assign(buckets + 1, 0);
+    for (const Entry& e : pending) ++bucketStart[bucketOf(e.cx, e.cz) + 1];
+    for (uint32_t b = 0; b < buckets; ++b) bucketStart[b + 1] += bucketStart[b];
+
+    entries.resize(pending.size());
+    // Scatter using bucketStart[b] as the write cursor, then shift the table back.
+    for (const Entry& e : pending) entries[bucketStart[bucketOf(e.cx, e.cz)]++] = e;
+    for (uint32_t b = buckets; b > 0; --b) bucketStart[b] = bucketStart[b - 1];
+    bucketStart[0] = 0;
+}
@@ -0,0 +1,107 @@
+#include "TaskGraph.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+int TaskGraph::Add(std::string name, Resources reads, Resources writes, std::function<void()> fn) {
+    const int index = static_cast<int>(nodes.size());
+    Node node;
+    node.name   = std::move(name);
+    node.reads  = reads;
+    node.writes = writes;
+    node.fn     = std::move(fn);
+    for (int j = 0; j < index; ++j) {
+        const Node& earlier = nodes[j];
+        const bool conflict = (writes & (earlier.reads | earlier.writes)) || (reads & earlier.writes);
+        if (!conflict) continue;
+        node.predecessors.push_back(j);
+        nodes[j].successors.push_back(index);
+    }
+    nodes.push_back(std::move(node));
+
+    // Launch records point back at this graph; rebuild them since nodes may have moved.
+    launches.clear();
+    for (int i = 0; i <= index; ++i) launches.push_back(Launch{ this, i });
+    waiting = std::make_unique<std::atomic<int>[]>(nodes.size());
+    pathFinish.resize(nodes.size());
+    pathVia.resize(nodes.size());
+    criticalPath.reserve(nodes.size());
+    return index;
+}
+
+double TaskGraph::secondsSinceStart() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+}
+
+void TaskGraph::runNode(void* ctx, unsigned) {
+    const Launch& launch = *static_cast<const Launch*>(ctx);
+    TaskGraph& g = *launch.graph;
+    Node& node = g.nodes[launch.node];
+
+    node.start = g.secondsSinceStart();
+    node.fn();
+    node.end = g.secondsSinceStart();
+
+    for (int s : node.successors) {
+        if (g.waiting[s].fetch_sub(1, std::memory_order_acq_rel) == 1) g.activeJobs->Enqueue(runNode, &g.launches[s]);
+    }
+    // Last, so the graph is never seen as finished while a successor is still being queued.
+    g.unfinished.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void TaskGraph::Run(JobSystem& jobs) {
+    if (nodes.empty()) return;
+    activeJobs = &jobs;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        waiting[i].store(static_cast<int>(nodes[i].predecessors.size()), std::memory_order_relaxed);
+    }
+    unfinished.store(nodes.size(), std::memory_order_release);
+    runStart = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].predecessors.empty()) jobs.Enqueue(runNode, &launches[i]);
+    }
+    jobs.HelpUntilZero(unfinished);
+
+    lastWall = secondsSinceStart();
+    computeCriticalPath();
+}
+
+// Longest chain by task duration. Predecessors always have lower indices, so one pass
+// in declaration order is a topological walk.
+void TaskGraph::computeCriticalPath() {
+    std::vector<double>& finish = pathFinish;
+    std::vector<int>&    via    = pathVia;
+    int last = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        double before = 0.0;
+        via[i] = -1;
+        for (int p : nodes[i].predecessors) {
+            if (finish[p] > before) { before = finish[p]; via[i] = p; }
+        }
+        finish[i] = before + TaskSeconds(static_cast<int>(i));
+        if (finish[i] > finish[last]) last = static_cast<int>(i);
+    }
+    lastCritical = finish[last];
+
+    criticalPath.clear();
+    for (int n = last; n >= 0; n = via[n]) criticalPath.push_back(n);
+    std::reverse(criticalPath.begin(), criticalPath.end());
+}
+
+void TaskGraph::DumpCriticalPath(std::ostream& out) const {
+    double work = 0.0;
+    for (size_t i = 0; i < nodes.size(); ++i) work += TaskSeconds(static_cast<int>(i));
+
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1)
+        << "wall " << lastWall * 1e6 << " us, work " << work * 1e6 << " us, critical " << lastCritical * 1e6 << " us:";
+    for (size_t k = 0; k < criticalPath.size(); ++k) {
+        out << (k == 0 ? " " : " > ") << nodes[criticalPath[k]].name << ' ' << TaskSeconds(criticalPath[k]) * 1e6;
+    }
+    out << '\n';
+    out.flags(flags);
+    out.precision(precision);
+}
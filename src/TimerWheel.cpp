@@ -0,0 +1,132 @@
+#include "TimerWheel.h"
+#include <bit>
+
+TimerWheel::TimerWheel() : lists(kLevels * kSlots + 1) {}
+
+void TimerWheel::Reset(uint32_t tick) {
+    freeNodes.clear();
+    for (uint32_t k = static_cast<uint32_t>(nodes.size()); k-- > 0;) {
+        Node& n = nodes[k];
+        if (n.list != kNoList) ++n.generation;
+        n.list = kNoList;
+        freeNodes.push_back(k);
+    }
+    for (List& l : lists) l = List();
+    now = tick;
+    pending = 0;
+    stats = TimerWheelStats();
+}
+
+TimerHandle TimerWheel::Schedule(uint32_t due, uint64_t tag) {
+    uint32_t k;
+    if (!freeNodes.empty()) {
+        k = freeNodes.back();
+        freeNodes.pop_back();
+    } else {
+        k = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+    nodes[k].tag = tag;
+    nodes[k].due = due;
+    place(k);
+    ++pending;
+    ++stats.scheduled;
+    return TimerHandle{ k, nodes[k].generation };
+}
+
+bool TimerWheel::Cancel(TimerHandle h) {
+    if (!Pending(h)) return false;
+    unlink(h.node);
+    release(h.node);
+    ++stats.cancelled;
+    return true;
+}
+
+// Files a timer by the highest 6-bit digit where its deadline differs from now. It moves
+// down when now reaches that digit, i.e. the start of its slot. Past a turn of the top
+// level it goes in the top slot that comes round last, and is filed again from there.
+void TimerWheel::place(uint32_t k) {
+    const uint32_t due = nodes[k].due;
+    if (static_cast<int32_t>(due - now) <= 0) {
+        append(kReadyList, k);
+        return;
+    }
+    const int level = (std::bit_width(due ^ now) - 1) / kSlotBits;
+    if (level < kLevels - 1) {
+        append(static_cast<uint32_t>(level) * kSlots + ((due >> (level * kSlotBits)) & kSlotMask), k);
+        return;
+    }
+    const int topShift = (kLevels - 1) * kSlotBits;
+    const uint32_t turns = (due >> topShift) - (now >> topShift);
+    const uint32_t slot = (turns < kSlots) ? (due >> topShift) : (now >> topShift) + kSlotMask;
+    append((kLevels - 1) * kSlots + (slot & kSlotMask), k);
+}
+
+void TimerWheel::append(uint32_t list, uint32_t k) {
+    Node& n = nodes[k];
+    List& l = lists[list];
+    n.list = list;
+    n.prev = l.tail;
+    n.next = kNil;
+    if (l.tail != kNil) nodes[l.tail].next = k;
+    else                l.head = k;
+    l.tail = k;
+}
+
+void TimerWheel::unlink(uint32_t k) {
+    Node& n = nodes[k];
+    List& l = lists[n.list];
+    if (n.prev != kNil) nodes[n.prev].next = n.next;
+    else                l.head = n.next;
+    if (n.next != kNil) nodes[n.next].prev = n.prev;
+    else                l.tail = n.prev;
+    n.list = kNoList;
+}
+
+void TimerWheel::release(uint32_t k) {
+    ++nodes[k].generation;
+    freeNodes.push_back(k);
+    --pending;
+}
+
+// When tick starts a slot on a coarser level, that slot's timers are filed again against
+// the new tick, in their original order, before the level-0 slot for tick is fired.
+void TimerWheel::beginTick(uint32_t tick) {
+    now = tick;
+    for (int level = kLevels - 1; level >= 1; --level) {
+        const int shift = level * kSlotBits;
+        if ((tick & ((1u << shift) - 1)) != 0) continue;
+        List& l = lists[static_cast<uint32_t>(level) * kSlots + ((tick >> shift) & kSlotMask)];
+        uint32_t k = l.head;
+        l = List();
+        while (k != kNil) {
+            const uint32_t next = nodes[k].next;
+            place(k);
+            ++stats.cascaded;
+            k = next;
+        }
+    }
+
+    List& slot = lists[tick & kSlotMask];
+    if (slot.head == kNil) return;
+    for (uint32_t k = slot.head; k != kNil; k = nodes[k].next) nodes[k].list = kReadyList;
+    List& ready = lists[kReadyList];
+    if (ready.tail != kNil) {
+        nodes[ready.tail].next = slot.head;
+        nodes[slot.head].prev = ready.tail;
+    } else {
+        ready.head = slot.head;
+    }
+    ready.tail = slot.tail;
+    slot = List();
+}
+
+bool TimerWheel::popReady(uint64_t& tag) {
+    const uint32_t k = lists[kReadyList].head;
+    if (k == kNil) return false;
+    unlink(k);
+    release(k);
+    ++stats.fired;
+    tag = nodes[k].tag;
+    return true;
+}
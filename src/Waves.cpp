@@ -0,0 +1,180 @@
+#include "Waves.h"
+#include "Ballistics.h"
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// Same rule as EnemyKernel.cpp: no fused multiply-adds, so every path rounds alike.
+#if defined(__GNUC__) && !defined(__clang__)
+#define NO_FP_CONTRACT __attribute__((optimize("fp-contract=off")))
+#else
+#define NO_FP_CONTRACT
+#endif
+
+// sin(x): x less the nearest multiple of 2 pi (in two parts, so the reduction stays exact for
+// the phases a long match reaches), folded onto [0, pi/2], then the odd Taylor polynomial to
+// x^9, which is within 4e-6 there. The sign of the reduced angle is put back at the end.
+static constexpr float kInvTwoPi = 0.159154943f;
+static constexpr float kTwoPiHi  = 6.28125f;           // 201/32, so k * kTwoPiHi is exact
+static constexpr float kTwoPiLo  = 0.00193530717958f;  // 2 pi - kTwoPiHi
+static constexpr float kPi       = 3.14159265f;
+static constexpr float kS3 = -1.0f / 6.0f;
+static constexpr float kS5 =  1.0f / 120.0f;
+static constexpr float kS7 = -1.0f / 5040.0f;
+static constexpr float kS9 =  1.0f / 362880.0f;
+
+namespace {
+
+// Derived once per call so every path uses the same rounded values.
+struct WaveConstants {
+    float alongX[3], alongZ[3]; // direction times frequency
+    float phase[3];
+    float height[3];            // times kWaveAmplitude
+};
+
+WaveConstants waveConstants(float time) {
+    WaveConstants c;
+    const float t = time * kWaveSpeed;
+    for (int k = 0; k < 3; ++k) {
+        c.alongX[k] = kWaveTerms[k].alongX * kWaveTerms[k].frequency;
+        c.alongZ[k] = kWaveTerms[k].alongZ * kWaveTerms[k].frequency;
+        c.phase[k]  = t * kWaveTerms[k].phaseSpeed;
+        c.height[k] = kWaveTerms[k].height * kWaveAmplitude;
+    }
+    return c;
+}
+
+} // namespace
+
+NO_FP_CONTRACT
+static float sinScalar(float x) {
+    const float k = std::nearbyint(x * kInvTwoPi);
+    const float r = (x - k * kTwoPiHi) - k * kTwoPiLo;
+    const float a = std::fabs(r);
+    const float f = std::min(a, kPi - a);
+    const float f2 = f * f;
+    const float s = f + f * (f2 * (kS3 + f2 * (kS5 + f2 * (kS7 + f2 * kS9))));
+    return std::signbit(r) ? -s : s;
+}
+
+NO_FP_CONTRACT
+static void sampleScalarRange(const WaveSamples& s, const WaveConstants& c, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        const float x = s.x[i], z = s.z[i];
+        float h = 0.0f;
+        for (int k = 0; k < 3; ++k) h = h + c.height[k] * sinScalar((x * c.alongX[k] + z * c.alongZ[k]) + c.phase[k]);
+        s.height[i] = h + kSeaLevel;
+    }
+}
+
+// Only SSE2 builds run the four-wide kernel; AVX builds use sampleAvx8 for the tail too.
+#if (defined(__SSE2__) || defined(_M_X64)) && !defined(__AVX__)
+NO_FP_CONTRACT
+static __m128 sinSse(__m128 x) {
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 k = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kInvTwoPi))));
+    const __m128 r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(kTwoPiHi))), _mm_mul_ps(k, _mm_set1_ps(kTwoPiLo)));
+    const __m128 a = _mm_andnot_ps(signBit, r);
+    const __m128 f = _mm_min_ps(a, _mm_sub_ps(_mm_set1_ps(kPi), a));
+    const __m128 f2 = _mm_mul_ps(f, f);
+    __m128 p = _mm_add_ps(_mm_set1_ps(kS7), _mm_mul_ps(f2, _mm_set1_ps(kS9)));
+    p = _mm_add_ps(_mm_set1_ps(kS5), _mm_mul_ps(f2, p));
+    p = _mm_add_ps(_mm_set1_ps(kS3), _mm_mul_ps(f2, p));
+    const __m128 s = _mm_add_ps(f, _mm_mul_ps(f, _mm_mul_ps(f2, p)));
+    return _mm_xor_ps(s, _mm_and_ps(signBit, r));
+}
+
+NO_FP_CONTRACT
+static void sampleSse4(const WaveSamples& s, const WaveConstants& c, size_t i) {
+    const __m128 x = _mm_loadu_ps(s.x + i), z = _mm_loadu_ps(s.z + i);
+    __m128 h = _mm_setzero_ps();
+    for (int k = 0; k < 3; ++k) {
+        const __m128 arg = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(c.alongX[k])), _mm_mul_ps(z, _mm_set1_ps(c.alongZ[k]))),
+                                      _mm_set1_ps(c.phase[k]));
+        h = _mm_add_ps(h, _mm_mul_ps(_mm_set1_ps(c.height[k]), sinSse(arg)));
+    }
+    _mm_storeu_ps(s.height + i, _mm_add_ps(h, _mm_set1_ps(kSeaLevel)));
+}
+#endif
+
+#if defined(__AVX__)
+NO_FP_CONTRACT
+static __m256 sinAvx(__m256 x) {
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    const __m256 k = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(kInvTwoPi)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    const __m256 r = _mm256_sub_ps(_mm256_sub_ps(x, _mm256_mul_ps(k, _mm256_set1_ps(kTwoPiHi))),
+                                   _mm256_mul_ps(k, _mm256_set1_ps(kTwoPiLo)));
+    const __m256 a = _mm256_andnot_ps(signBit, r);
+    const __m256 f = _mm256_min_ps(a, _mm256_sub_ps(_mm256_set1_ps(kPi), a));
+    const __m256 f2 = _mm256_mul_ps(f, f);
+    __m256 p = _mm256_add_ps(_mm256_set1_ps(kS7), _mm256_mul_ps(f2, _mm256_set1_ps(kS9)));
+    p = _mm256_add_ps(_mm256_set1_ps(kS5), _mm256_mul_ps(f2, p));
+    p = _mm256_add_ps(_mm256_set1_ps(kS3), _mm256_mul_ps(f2, p));
+    const __m256 s = _mm256_add_ps(f, _mm256_mul_ps(f, _mm256_mul_ps(f2, p)));
+    return _mm256_xor_ps(s, _mm256_and_ps(signBit, r));
+}
+
+NO_FP_CONTRACT
+static void sampleAvx8(const WaveSamples& s, const WaveConstants& c, size_t i) {
+    const __m256 x = _mm256_loadu_ps(s.x + i), z = _mm256_loadu_ps(s.z + i);
+    __m256 h = _mm256_setzero_ps();
+    for (int k = 0; k < 3; ++k) {
+        const __m256 arg = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(c.alongX[k])),
+                                                       _mm256_mul_ps(z, _mm256_set1_ps(c.alongZ[k]))),
+                                         _mm256_set1_ps(c.phase[k]));
+        h = _mm256_add_ps(h, _mm256_mul_ps(_mm256_set1_ps(c.height[k]), sinAvx(arg)));
+    }
+    _mm256_storeu_ps(s.height + i, _mm256_add_ps(h, _mm256_set1_ps(kSeaLevel)));
+}
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+// The last few points are copied into a padded block and run through the same vector code.
+template <size_t Width, typename Kernel>
+static void sampleTail(const WaveSamples& s, const WaveConstants& c, size_t begin, Kernel kernel) {
+    const size_t n = s.count - begin;
+    if (n == 0) return;
+    float x[Width] = {}, z[Width] = {}, h[Width] = {};
+    std::copy_n(s.x + begin, n, x);
+    std::copy_n(s.z + begin, n, z);
+    kernel(WaveSamples{ x, z, h, Width }, c, 0);
+    std::copy_n(h, n, s.height + begin);
+}
+#endif
+
+void SampleWaveHeights(const WaveSamples& s, float time) {
+    const WaveConstants c = waveConstants(time);
+#if defined(__AVX__)
+    size_t i = 0;
+    for (; i + 8 <= s.count; i += 8) sampleAvx8(s, c, i);
+    sampleTail<8>(s, c, i, sampleAvx8);
+#elif defined(__SSE2__) || defined(_M_X64)
+    size_t i = 0;
+    for (; i + 4 <= s.count; i += 4) sampleSse4(s, c, i);
+    sampleTail<4>(s, c, i, sampleSse4);
+#else
+    sampleScalarRange(s, c, 0, s.count);
+#endif
+}
+
+void SampleWaveHeightsScalar(const WaveSamples& s, float time) {
+    sampleScalarRange(s, waveConstants(time), 0, s.count);
+}
+
+float WaveHeight(float x, float z, float time) {
+    float h = 0.0f;
+    SampleWaveHeights(WaveSamples{ &x, &z, &h, 1 }, time);
+    return h;
+}
+
+const char* WaveSamplePath() {
+#if defined(__AVX__)
+    return "avx";
+#elif defined(__SSE2__) || defined(_M_X64)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -1,22 +1,80 @@
 #include "../include/Game.h"
+#include "../include/Benchmarks.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 
 const unsigned int WINDOW_WIDTH = 1024;
 const unsigned int WINDOW_HEIGHT = 768;
 
-int main() {
+// Usage: BoatEscape [--tick-rate 30|60|120] [--record FILE]
+//                   [--replay FILE [--max-speed]]
+//                   [--headless [--ticks N] [--seed S] [--difficulty easy|hard]]
+//                   [--threads N] [--dump-task-graph] [--bench NAME]
+static void parseCommandLine(int argc, char** argv, LaunchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = (i + 1 < argc);
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            options.headless = true;
+        } else if (std::strcmp(argv[i], "--max-speed") == 0) {
+            options.maxSpeed = true;
+        } else if (std::strcmp(argv[i], "--dump-task-graph") == 0) {
+            options.dumpTaskGraph = true;
+        } else if (std::strcmp(argv[i], "--ticks") == 0 && hasValue) {
+            options.ticks = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--tick-rate") == 0 && hasValue) {
+            options.tickRate = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--difficulty") == 0 && hasValue) {
+            options.difficulty = (std::strcmp(argv[++i], "easy") == 0) ? EASY : HARD;
+        } else if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+            options.recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && hasValue) {
+            options.replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            options.threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--bench") == 0 && hasValue) {
+            options.benchmark = argv[++i];
+        } else {
+            std::cout << "Ignoring unknown argument: " << argv[i] << "\n";
+        }
+    }
+}
+
+int main(int argc, char** argv) {
     Game game(WINDOW_WIDTH, WINDOW_HEIGHT);
+
+    LaunchOptions options;
+    parseCommandLine(argc, argv, options);
+    game.SetRecordPath(options.replayPath.empty() ? options.recordPath : std::string());
+    game.SetThreadCount(options.threads);
+    game.SetDumpTaskGraph(options.dumpTaskGraph);
+
+    if (!options.benchmark.empty()) {
+        return RunBenchmark(options.benchmark);
+    }
+    if (options.headless) {
+        return game.RunHeadless(options);
+    }
+
+    game.SetTickRate(options.tickRate);
     game.Init();
+    if (!options.replayPath.empty() && !game.StartReplay(options.replayPath)) {
+        return 1;
+    }
+    // At max speed every rendered frame advances exactly one tick, whatever the wall clock says.
+    const bool oneTickPerFrame = options.maxSpeed && game.IsReplaying();
 
-    float deltaTime = 0.0f;
-    float lastFrame = 0.0f;
+    double lastFrame = glfwGetTime();
 
     while (game.IsRunning()) {
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
+        const double currentFrame = glfwGetTime();
+        const double frameSeconds = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
-        game.ProcessInput(deltaTime);
-        game.Update(deltaTime);
+        game.ProcessInput(game.PollInput());
+        game.Advance(oneTickPerFrame ? 1.0 / game.GetTickRate() : frameSeconds);
         game.Render();
 
         glfwSwapBuffers(game.GetWindow());
@@ -26,4 +84,3 @@ int main() {
 
     return 0;
 }
-